@@ -30,10 +30,19 @@ enum irsdk_StatusField {
     irsdk_stConnected = 1
 };
 
+// ─── Track location (CarIdxTrackSurface) ─────────────────────
+enum irsdk_TrkLoc {
+    irsdk_NotInWorld     = -1,
+    irsdk_OffTrack       = 0,
+    irsdk_InPitStall     = 1,
+    irsdk_AproachingPits = 2,   // sic, official spelling
+    irsdk_OnTrack        = 3
+};
+
 // ─── Variable types ──────────────────────────────────────────
 enum irsdk_VarType {
     irsdk_char     = 0,   // 1 byte
-    irsdk_bool     = 1,   // 1 byte  (stored as int in the buffer though)
+    irsdk_bool     = 1,   // 1 byte
     irsdk_int      = 2,   // 4 bytes
     irsdk_bitField = 3,   // 4 bytes
     irsdk_float    = 4,   // 4 bytes
@@ -123,4 +132,22 @@ struct irsdk_header {
     irsdk_varBuf varBuf[IRSDK_MAX_BUFS];  // data buffers
 };
 
+// ─── Disk sub-header (.ibt files, follows irsdk_header) ──────
+// Official layout:
+//   time_t sessionStartDate    +0    (64-bit)
+//   double sessionStartTime    +8
+//   double sessionEndTime      +16
+//   int    sessionLapCount     +24
+//   int    sessionRecordCount  +28
+//                              =32
+// In a .ibt file varBuf[0].bufOffset is the first row and the
+// sessionRecordCount rows follow back to back, bufLen bytes each.
+struct irsdk_diskSubHeader {
+    long long sessionStartDate;
+    double sessionStartTime;
+    double sessionEndTime;
+    int sessionLapCount;
+    int sessionRecordCount;
+};
+
 #endif // IRSDK_DEFINES_H
@@ -0,0 +1,117 @@
+#include "data/car_frame.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace iracing {
+
+namespace {
+
+// Copies up to CarFrame::kMaxCars elements of a variable into dst,
+// converting from the declared irsdk type, and pads the rest with fallback
+template<typename T>
+int readColumn(const char* row, const VarHandle& var, T* dst, T fallback) {
+    int n = 0;
+    if (row && var.isValid()) {
+        n = std::min(var.count, CarFrame::kMaxCars);
+        const char* src = row + var.offset;
+
+        switch (var.type) {
+            case irsdk_int:
+            case irsdk_bitField:
+                if (std::is_same<T, int>::value) {
+                    memcpy(dst, src, n * sizeof(int));
+                } else {
+                    for (int i = 0; i < n; ++i) {
+                        int32_t v;
+                        memcpy(&v, src + i * 4, 4);
+                        dst[i] = static_cast<T>(v);
+                    }
+                }
+                break;
+            case irsdk_float:
+                if (std::is_same<T, float>::value) {
+                    memcpy(dst, src, n * sizeof(float));
+                } else {
+                    for (int i = 0; i < n; ++i) {
+                        float v;
+                        memcpy(&v, src + i * 4, 4);
+                        dst[i] = static_cast<T>(v);
+                    }
+                }
+                break;
+            case irsdk_double:
+                for (int i = 0; i < n; ++i) {
+                    double v;
+                    memcpy(&v, src + i * 8, 8);
+                    dst[i] = static_cast<T>(v);
+                }
+                break;
+            case irsdk_bool:
+                for (int i = 0; i < n; ++i) dst[i] = static_cast<T>(src[i] != 0);
+                break;
+            case irsdk_char:
+                for (int i = 0; i < n; ++i) dst[i] = static_cast<T>(src[i]);
+                break;
+            default:
+                n = 0;
+                break;
+        }
+    }
+
+    std::fill(dst + n, dst + CarFrame::kMaxCars, fallback);
+    return n;
+}
+
+} // namespace
+
+void CarFrame::clear() {
+    tickCount = -1;
+    carCount = 0;
+    std::fill(lap, lap + kMaxCars, 0);
+    std::fill(lapCompleted, lapCompleted + kMaxCars, 0);
+    std::fill(position, position + kMaxCars, 0);
+    std::fill(trackSurface, trackSurface + kMaxCars, (int)irsdk_NotInWorld);
+    std::fill(lapDistPct, lapDistPct + kMaxCars, -1.0f);
+    std::fill(f2Time, f2Time + kMaxCars, -1.0f);
+    std::fill(lastLapTime, lastLapTime + kMaxCars, -1.0f);
+    std::fill(onPitRoad, onPitRoad + kMaxCars, (uint8_t)0);
+}
+
+void CarFrameReader::resolve(const IRSDKManager& sdk) {
+    m_lap = sdk.getVarHandle("CarIdxLap");
+    m_lapCompleted = sdk.getVarHandle("CarIdxLapCompleted");
+    m_position = sdk.getVarHandle("CarIdxPosition");
+    m_trackSurface = sdk.getVarHandle("CarIdxTrackSurface");
+    m_lapDistPct = sdk.getVarHandle("CarIdxLapDistPct");
+    m_f2Time = sdk.getVarHandle("CarIdxF2Time");
+    m_lastLapTime = sdk.getVarHandle("CarIdxLastLapTime");
+    m_onPitRoad = sdk.getVarHandle("CarIdxOnPitRoad");
+    m_generation = sdk.getHeaderGeneration();
+}
+
+bool CarFrameReader::read(const IRSDKManager& sdk, CarFrame& frame) {
+    if (sdk.getHeaderGeneration() != m_generation) resolve(sdk);
+
+    const TelemetrySnapshot& snapshot = sdk.getSnapshot();
+    const char* row = snapshot.data();
+    if (!row || !m_lapDistPct.isValid()) {
+        frame.clear();
+        return false;
+    }
+
+    frame.carCount = readColumn(row, m_lapDistPct, frame.lapDistPct, -1.0f);
+    readColumn(row, m_lap, frame.lap, 0);
+    readColumn(row, m_lapCompleted, frame.lapCompleted, 0);
+    readColumn(row, m_position, frame.position, 0);
+    // Without a surface column, placement is judged by lapDistPct alone
+    readColumn(row, m_trackSurface, frame.trackSurface,
+               (int)(m_trackSurface.isValid() ? irsdk_NotInWorld : irsdk_OnTrack));
+    readColumn(row, m_f2Time, frame.f2Time, -1.0f);
+    readColumn(row, m_lastLapTime, frame.lastLapTime, -1.0f);
+    readColumn(row, m_onPitRoad, frame.onPitRoad, (uint8_t)0);
+    frame.tickCount = snapshot.tickCount();
+    return true;
+}
+
+} // namespace iracing
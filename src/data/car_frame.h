@@ -0,0 +1,62 @@
+#ifndef CAR_FRAME_H
+#define CAR_FRAME_H
+
+#include "data/irsdk_manager.h"
+#include <cstdint>
+
+namespace iracing {
+
+// One tick of the CarIdx* telemetry arrays in struct-of-arrays form.
+// Fixed capacity, each column 64-byte aligned and indexed by CarIdx, so
+// per-car passes (sorting, gaps, SOF) walk contiguous memory and never
+// allocate. Slots past carCount, or missing from the telemetry, hold the
+// "not in world" defaults (-1 distances/times, NotInWorld surface).
+struct CarFrame {
+    static constexpr int kMaxCars = 64;
+
+    int tickCount = -1;
+    int carCount = 0;
+
+    alignas(64) int lap[kMaxCars];
+    alignas(64) int lapCompleted[kMaxCars];
+    alignas(64) int position[kMaxCars];
+    alignas(64) int trackSurface[kMaxCars];
+    alignas(64) float lapDistPct[kMaxCars];
+    alignas(64) float f2Time[kMaxCars];
+    alignas(64) float lastLapTime[kMaxCars];
+    alignas(64) uint8_t onPitRoad[kMaxCars];
+
+    CarFrame() { clear(); }
+    void clear();
+
+    // Car is on the server and placed on track (or in the pits)
+    bool isInWorld(int carIdx) const {
+        return trackSurface[carIdx] >= 0 && lapDistPct[carIdx] >= -0.5f && position[carIdx] >= 0;
+    }
+};
+
+// Copies the CarIdx* variables of the manager's current row into a
+// CarFrame, converting by declared type (irsdk_bool is one byte, doubles
+// are narrowed). Handles are cached and re-resolved after a reconnect.
+class CarFrameReader {
+public:
+    // Returns false when the row has no CarIdxLapDistPct (frame cleared)
+    bool read(const IRSDKManager& sdk, CarFrame& frame);
+
+private:
+    void resolve(const IRSDKManager& sdk);
+
+    int m_generation = -1;
+    VarHandle m_lap;
+    VarHandle m_lapCompleted;
+    VarHandle m_position;
+    VarHandle m_trackSurface;
+    VarHandle m_lapDistPct;
+    VarHandle m_f2Time;
+    VarHandle m_lastLapTime;
+    VarHandle m_onPitRoad;
+};
+
+} // namespace iracing
+
+#endif // CAR_FRAME_H
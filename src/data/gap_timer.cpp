@@ -0,0 +1,115 @@
+#include "data/gap_timer.h"
+#include "data/lap_step.h"
+#include <algorithm>
+
+namespace iracing {
+
+GapTimer::GapTimer()
+    : m_times((size_t)CarFrame::kMaxCars * kBins, -1.0)
+{
+}
+
+void GapTimer::reset() {
+    std::fill(m_times.begin(), m_times.end(), -1.0);
+    for (Car& car : m_cars) car = Car();
+    m_now = 0.0;
+}
+
+void GapTimer::update(const CarFrame& f, double now) {
+    if (now < m_now) reset();
+    m_now = now;
+
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        Car& car = m_cars[i];
+        if (i >= f.carCount || !f.isInWorld(i) || f.lapDistPct[i] < 0.0f) {
+            car.valid = false;
+            continue;
+        }
+        const float pct = f.lapDistPct[i] >= 1.0f ? 0.0f : f.lapDistPct[i];
+        if (!car.valid) {
+            car = Car();
+            car.valid = true;
+            car.laps = f.lapCompleted[i];
+            car.pct = pct;
+            car.time = now;
+            continue;
+        }
+
+        const LapStep step(car.pct, pct);
+        if (step.kind == LapStep::Still) continue;
+        if (step.kind == LapStep::Jump) {
+            // Off the recorded path; previous crossings stay usable, but
+            // the next line crossing does not close a timed lap
+            car.laps = f.lapCompleted[i];
+            car.pct = pct;
+            car.time = now;
+            car.timingLap = false;
+            continue;
+        }
+        // Boundaries b / kBins passed since the previous tick
+        double* t = times(i);
+        LapSpan(car.pct, step, car.time, now, kBins).forEachBoundary([&](int b, double at) {
+            const int bin = b % kBins;
+            if (bin == 0) {
+                if (car.timingLap) car.lapSeconds = (float)(at - t[0]);
+                car.timingLap = true;
+            }
+            t[bin] = at;
+        });
+
+        if (step.wrapped) ++car.laps;
+        car.pct = pct;
+        car.time = now;
+    }
+}
+
+bool GapTimer::timeBehind(int car, int ref, double& seconds) const {
+    const Car& c = m_cars[car];
+    const Car& r = m_cars[ref];
+    const double x = c.pct;
+    const double* t = times(ref);
+
+    // When ref last passed x, interpolated within the bin: towards the
+    // next boundary if ref has crossed it since, else towards ref's
+    // current position
+    const int b = std::min((int)(x * kBins), kBins - 1);
+    const double tb = t[b];
+    if (tb < 0.0) return false;
+    const double bx = (double)b / kBins;
+    const double tn = t[(b + 1) % kBins];
+    double passed;
+    if (tn > tb) {
+        passed = tb + (tn - tb) * (x - bx) * kBins;
+    } else {
+        const double span = r.pct - bx;
+        passed = span > 0.0 ? tb + (m_now - tb) * (x - bx) / span : tb;
+    }
+
+    // A crossing older than a lap belongs to an interrupted record
+    const double since = m_now - passed;
+    if (since > (r.lapSeconds > 0.0f ? 1.5 * r.lapSeconds : 600.0)) return false;
+
+    // Whole laps between ref's pass of x and car being there now
+    const int passLap = r.pct >= x ? r.laps : r.laps - 1;
+    const int laps = passLap - c.laps;
+    if (laps < 0 || (laps > 0 && r.lapSeconds <= 0.0f)) return false;
+
+    seconds = since + (double)laps * r.lapSeconds;
+    return true;
+}
+
+bool GapTimer::gap(int car, int ref, float& seconds) const {
+    if (car < 0 || ref < 0 || car >= CarFrame::kMaxCars || ref >= CarFrame::kMaxCars) return false;
+    if (!m_cars[car].valid || !m_cars[ref].valid) return false;
+    if (car == ref) { seconds = 0.0f; return true; }
+
+    const Car& c = m_cars[car];
+    const Car& r = m_cars[ref];
+    const bool behind = c.laps + c.pct <= r.laps + r.pct;
+    double s = 0.0;
+    if (!(behind ? timeBehind(car, ref, s) : timeBehind(ref, car, s))) return false;
+    seconds = (float)(behind ? s : -s);
+    return true;
+}
+
+} // namespace iracing
@@ -0,0 +1,59 @@
+#ifndef GAP_TIMER_H
+#define GAP_TIMER_H
+
+#include "data/car_frame.h"
+#include <vector>
+
+namespace iracing {
+
+// Time gaps from track position alone, for sessions without CarIdxF2Time.
+// The lap is split into kBins equal bins and every car records the
+// SessionTime at which it last crossed each bin boundary (interpolated
+// between ticks). The gap of a car behind another is then "now minus when
+// the other car passed this spot", plus whole laps for lapped cars.
+//
+// Memory is fixed at construction (kMaxCars * kBins times); update() only
+// touches the boundaries each car crossed since the previous tick.
+class GapTimer {
+public:
+    static constexpr int kBins = 1000;
+
+    GapTimer();
+
+    // Forgets every crossing (new session, reconnect, replay seek)
+    void reset();
+
+    // Records the crossings since the previous frame. A time going
+    // backwards resets; a car moving back or jumping more than a tenth of
+    // a lap in one tick (tow, reset to pits) starts its record over.
+    void update(const CarFrame& frame, double sessionTime);
+
+    // Seconds car is behind ref (negative when ahead, as F2Time
+    // differences). False when the needed crossing was not recorded yet.
+    bool gap(int car, int ref, float& seconds) const;
+
+    // Duration of car's last complete lap as timed at the line, or 0
+    float lapTime(int car) const { return (car >= 0 && car < CarFrame::kMaxCars) ? m_cars[car].lapSeconds : 0.0f; }
+
+private:
+    struct Car {
+        bool valid = false;
+        int laps = 0;           // own lap count, advanced on each wrap
+        float pct = 0.0f;       // at the last update
+        double time = 0.0;
+        float lapSeconds = 0.0f;
+        bool timingLap = false; // boundary 0 recorded since the record (re)started
+    };
+
+    bool timeBehind(int car, int ref, double& seconds) const;
+    double* times(int car) { return m_times.data() + (size_t)car * kBins; }
+    const double* times(int car) const { return m_times.data() + (size_t)car * kBins; }
+
+    std::vector<double> m_times;  // per car, crossing time of each boundary, < 0 = none
+    Car m_cars[CarFrame::kMaxCars];
+    double m_now = 0.0;
+};
+
+} // namespace iracing
+
+#endif // GAP_TIMER_H
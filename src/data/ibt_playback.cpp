@@ -0,0 +1,155 @@
+#include "data/ibt_playback.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace iracing {
+
+IbtPlayback::IbtPlayback(std::string path)
+    : m_path(std::move(path))
+{
+}
+
+bool IbtPlayback::open() {
+    if (!m_file.open(m_path)) {
+        std::cerr << "[IBT] Cannot open " << m_path << std::endl;
+        return false;
+    }
+
+    const size_t headerBytes = sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader);
+    if (m_file.size() < headerBytes) {
+        m_file.close();
+        return false;
+    }
+
+    memcpy(&m_header, m_file.data(), sizeof(irsdk_header));
+    memcpy(&m_disk, m_file.data() + sizeof(irsdk_header), sizeof(irsdk_diskSubHeader));
+
+    m_firstRowOffset = m_header.varBuf[0].bufOffset;
+    if (m_header.ver < 1 || m_header.bufLen <= 0 || m_header.numVars <= 0 ||
+        m_firstRowOffset < (int)headerBytes || (size_t)m_firstRowOffset >= m_file.size()) {
+        std::cerr << "[IBT] Not a telemetry file: " << m_path << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    // A crashed recording leaves the record count at 0: trust the file size
+    long long available = (long long)(m_file.size() - m_firstRowOffset) / m_header.bufLen;
+    m_recordCount = m_disk.sessionRecordCount;
+    if (m_recordCount <= 0 || m_recordCount > available) {
+        m_recordCount = (int)std::min<long long>(available, 0x7FFFFFFF);
+    }
+    if (m_recordCount <= 0) {
+        m_file.close();
+        return false;
+    }
+
+    // Present the file as a connected, single-buffer live header
+    m_header.status = irsdk_stConnected;
+    m_header.numBuf = 1;
+    memset(&m_header.varBuf[1], 0, sizeof(irsdk_varBuf) * (IRSDK_MAX_BUFS - 1));
+    if (m_header.tickRate <= 0) m_header.tickRate = 60;
+
+    std::cout << "[IBT] " << m_path << ": " << m_recordCount << " records at "
+              << m_header.tickRate << " Hz" << std::endl;
+
+    publish(0);
+    m_pending = true;
+    rebase();
+    return true;
+}
+
+void IbtPlayback::close() {
+    m_file.close();
+    m_header = {};
+    m_recordCount = 0;
+    m_current = -1;
+    m_pending = false;
+}
+
+void IbtPlayback::publish(int record) {
+    m_current = record;
+    m_header.varBuf[0].tickCount = record;
+
+    // bufOffset is an int; past 2 GB it keeps pointing at the first row and
+    // readers go through row() instead
+    long long offset = m_firstRowOffset + (long long)record * m_header.bufLen;
+    m_header.varBuf[0].bufOffset = offset <= 0x7FFFFFFF ? (int)offset : m_firstRowOffset;
+}
+
+const char* IbtPlayback::row(int index) const {
+    (void)index;  // single buffer
+    return m_file.data() + m_firstRowOffset + (size_t)m_current * (size_t)m_header.bufLen;
+}
+
+void IbtPlayback::rebase() {
+    m_baseTime = Clock::now();
+    m_baseRecord = std::max(0, m_current);
+}
+
+bool IbtPlayback::waitForDataValid(int timeoutMS) {
+    if (!m_file.isOpen()) return false;
+
+    if (m_pending) {
+        m_pending = false;
+        return true;
+    }
+    if (!m_playing || isFinished()) return false;
+
+    if (m_maxSpeed) {
+        publish(m_current + 1);
+        return true;
+    }
+
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(std::max(0, timeoutMS));
+    const double recordsPerSecond = m_header.tickRate * m_speed;
+
+    for (;;) {
+        double elapsed = std::chrono::duration<double>(Clock::now() - m_baseTime).count();
+        int target = std::min(m_recordCount - 1, m_baseRecord + (int)(elapsed * recordsPerSecond));
+        if (target != m_current) {
+            // Late consumers skip records, exactly like a slow reader of the live sim
+            publish(target);
+            return true;
+        }
+
+        Clock::time_point next = m_baseTime + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>((m_current + 1 - m_baseRecord) / recordsPerSecond));
+        if (next > deadline) return false;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void IbtPlayback::play() {
+    if (m_playing) return;
+    m_playing = true;
+    rebase();
+}
+
+void IbtPlayback::pause() {
+    m_playing = false;
+}
+
+void IbtPlayback::seek(int record) {
+    if (m_recordCount <= 0) return;
+    publish(std::clamp(record, 0, m_recordCount - 1));
+    m_pending = true;
+    rebase();
+}
+
+void IbtPlayback::seekTime(double seconds) {
+    seek((int)(seconds * m_header.tickRate));
+}
+
+void IbtPlayback::setSpeed(double speed) {
+    m_speed = speed > 0.0 ? speed : 1.0;
+    rebase();
+}
+
+void IbtPlayback::setMaxSpeed(bool enabled) {
+    m_maxSpeed = enabled;
+    rebase();
+}
+
+} // namespace iracing
@@ -0,0 +1,74 @@
+#ifndef IBT_PLAYBACK_H
+#define IBT_PLAYBACK_H
+
+#include "data/telemetry_transport.h"
+#include "utils/mapped_file.h"
+#include <chrono>
+#include <string>
+
+namespace iracing {
+
+// Plays back an iRacing .ibt disk telemetry file through IRSDKManager.
+//
+// The file is memory-mapped and never loaded into RAM; each recorded row
+// is exposed in place by presenting a single-buffer irsdk_header whose
+// varBuf[0] points at the current record. Pacing happens in
+// waitForDataValid(), so the manager's normal polling drives playback.
+class IbtPlayback : public TelemetryTransport {
+public:
+    explicit IbtPlayback(std::string path);
+    ~IbtPlayback() override { close(); }
+
+    bool open() override;
+    void close() override;
+
+    const char* data() const override { return m_file.data(); }
+    size_t size() const override { return m_file.size(); }
+    const irsdk_header* header() const override { return &m_header; }
+
+    bool waitForDataValid(int timeoutMS) override;
+    bool hasDataValidSignal() const override { return m_file.isOpen(); }
+    bool hasStableRows() const override { return true; }
+    const char* row(int index) const override;
+
+    // Playback control
+    void play();
+    void pause();
+    bool isPlaying() const { return m_playing; }
+    bool isFinished() const { return m_recordCount > 0 && m_current >= m_recordCount - 1; }
+
+    void seek(int record);
+    void seekTime(double seconds);  // relative to the first record
+    void setSpeed(double speed);    // 1.0 = real time
+    void setMaxSpeed(bool enabled); // every record, as fast as they are consumed
+
+    int recordCount() const { return m_recordCount; }
+    int currentRecord() const { return m_current; }
+    const irsdk_diskSubHeader& diskHeader() const { return m_disk; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void publish(int record);
+    void rebase();  // restart the pacing clock at the current record
+
+    std::string m_path;
+    utils::MappedFile m_file;
+    irsdk_header m_header = {};
+    irsdk_diskSubHeader m_disk = {};
+
+    int m_firstRowOffset = 0;
+    int m_recordCount = 0;
+    int m_current = -1;
+    bool m_pending = false;  // published while paused, not yet reported
+
+    bool m_playing = true;
+    bool m_maxSpeed = false;
+    double m_speed = 1.0;
+    Clock::time_point m_baseTime;
+    int m_baseRecord = 0;
+};
+
+} // namespace iracing
+
+#endif // IBT_PLAYBACK_H
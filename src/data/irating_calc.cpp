@@ -5,35 +5,92 @@
 
 namespace iracing {
 
+namespace {
+
+// 1600 / ln 2: a 1600 point difference halves the exponent term
+constexpr double kBase = 2308.3120381;
+
+// Ratings at or below 0 would make a zero exponent term and 0/0 chances
+double exponentTerm(int iRating) {
+    return std::exp(-std::max(iRating, 1) / kBase);
+}
+
+double chance(double expA, double expB) {
+    return (1.0 - expA) * expB / ((1.0 - expB) * expA + (1.0 - expA) * expB);
+}
+
+int projectedDelta(double expected, int position, int count) {
+    const double fudge = (count / 2.0 - position) / 100.0;
+    const double delta = (count - position - expected - fudge) * 200.0 / count;
+    // Half away from zero, without a libm call per driver and tick
+    return delta >= 0.0 ? static_cast<int>(delta + 0.5) : -static_cast<int>(0.5 - delta);
+}
+
+} // namespace
+
 int iRatingCalculator::calculateSOF(const std::vector<int>& iRatings) {
-    if (iRatings.empty()) return 0;
-    
+    return calculateSOF(iRatings.data(), static_cast<int>(iRatings.size()));
+}
+
+int iRatingCalculator::calculateSOF(const int* iRatings, int count) {
+    if (!iRatings || count <= 0) return 0;
+
     double sum = 0.0;
-    for (int ir : iRatings) {
-        sum += ir;
+    for (int i = 0; i < count; ++i) {
+        sum += exponentTerm(iRatings[i]);
     }
-    return static_cast<int>(std::round(sum / iRatings.size()));
+    return static_cast<int>(std::lround(kBase * std::log(count / sum)));
 }
 
 int iRatingCalculator::calculateDelta(int myIR, int sof, int position, int totalDrivers) {
-    if (totalDrivers <= 1) return 0;
-    
-    // Very simple but realistic projection:
-    // - Top 3: small gain/loss
-    // - Mid pack: bigger swings
-    // - Back: big losses if bad finish
-    double expectedFinish = (myIR / static_cast<double>(sof)) * totalDrivers;
-    double actualFinish = position;
-    
-    double performance = (expectedFinish - actualFinish) / totalDrivers;
-    
-    int delta = static_cast<int>(performance * 120.0);  // scale factor feels natural
-    
-    // Clamp to reasonable values
-    if (delta > 50) delta = 50;
-    if (delta < -80) delta = -80;
-    
-    return delta;
+    if (totalDrivers <= 1 || position < 1) return 0;
+
+    // The other starters all rated sof; against itself a driver scores the
+    // 0.5 that the expected score leaves out
+    const double expected = (totalDrivers - 1) * chance(exponentTerm(myIR), exponentTerm(sof));
+    return projectedDelta(expected, position, totalDrivers);
+}
+
+void iRatingField::setField(const int* iRatings, int count) {
+    m_count = std::clamp(count, 0, kMaxDrivers);
+    double sum = 0.0;
+    for (int i = 0; i < m_count; ++i) {
+        const double e = exponentTerm(iRatings[i]);
+        sum += e;
+        m_exp[i] = static_cast<float>(e);
+        m_oneMinus[i] = static_cast<float>(1.0 - e);
+    }
+    // Padding: exp 0 gives a 0 chance against them, never 0/0
+    for (int i = m_count; i < kPadded; ++i) {
+        m_exp[i] = 0.0f;
+        m_oneMinus[i] = 1.0f;
+    }
+    m_sof = m_count > 0 ? static_cast<int>(std::lround(kBase * std::log(m_count / sum))) : 0;
+
+    // Branch-free over whole vectors, the driver itself included (it
+    // scores exactly 0.5 against itself, taken off at the end). Eight
+    // separate sums so the compiler can keep them in one vector register
+    // without reordering a single float sum.
+    const int n = (m_count + 7) / 8 * 8;
+    for (int i = 0; i < m_count; ++i) {
+        const float ei = m_exp[i];
+        const float fi = m_oneMinus[i];
+        float lanes[8] = {};
+        for (int j = 0; j < n; j += 8) {
+            for (int k = 0; k < 8; ++k) {
+                const float num = fi * m_exp[j + k];
+                lanes[k] += num / (m_oneMinus[j + k] * ei + num);
+            }
+        }
+        float total = 0.0f;
+        for (float lane : lanes) total += lane;
+        m_expected[i] = total - 0.5f;
+    }
+}
+
+int iRatingField::delta(int slot, int position) const {
+    if (m_count <= 1 || slot < 0 || slot >= m_count || position < 1) return 0;
+    return projectedDelta(m_expected[slot], position, m_count);
 }
 
 } // namespace iracing
@@ -3,10 +3,44 @@
 
 namespace iracing {
 
+// iRating model as the community has reverse-engineered it: the strength
+// of field is an Elo-style log-mean of exp(-iR / (1600 / ln 2)) terms, and
+// a driver's change is their actual score minus the expected one, the sum
+// of their pairwise chances of beating every other starter
 class iRatingCalculator {
 public:
     static int calculateSOF(const std::vector<int>& iRatings);
+    static int calculateSOF(const int* iRatings, int count);
+    // One driver against a field of totalDrivers all rated sof
     static int calculateDelta(int myIR, int sof, int position, int totalDrivers);
 };
 
+// The pairwise model for one field (a class, in multi-class races).
+// setField() computes every driver's expected score, O(n²), and is only
+// needed when the members or their ratings change; delta() is the part
+// that depends on the finishing position, cheap enough for every tick.
+class iRatingField {
+public:
+    static constexpr int kMaxDrivers = 64;
+
+    // Ratings by slot; slots past count are unused
+    void setField(const int* iRatings, int count);
+
+    int count() const { return m_count; }
+    int sof() const { return m_sof; }
+    float expectedScore(int slot) const { return m_expected[slot]; }
+    // Projected change for the driver in slot finishing at position (1-based)
+    int delta(int slot, int position) const;
+
+private:
+    // Padded to whole vectors with drivers that score 0 against anyone
+    static constexpr int kPadded = (kMaxDrivers + 7) / 8 * 8;
+
+    int m_count = 0;
+    int m_sof = 0;
+    float m_expected[kMaxDrivers] = {};
+    alignas(32) float m_exp[kPadded] = {};      // exp(-iR / (1600 / ln 2))
+    alignas(32) float m_oneMinus[kPadded] = {}; // 1 - the same
+};
+
 } // namespace iracing
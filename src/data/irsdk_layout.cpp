@@ -0,0 +1,122 @@
+#include "data/irsdk_layout.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace iracing {
+
+namespace {
+
+constexpr int kRowAlignment = 16;
+
+int alignUp(int value, int alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+irsdk_header* headerOf(char* mem) {
+    return reinterpret_cast<irsdk_header*>(mem);
+}
+
+} // namespace
+
+int IRSDKLayout::typeSize(int type) {
+    switch (type) {
+        case irsdk_char:
+        case irsdk_bool:     return 1;
+        case irsdk_int:
+        case irsdk_bitField:
+        case irsdk_float:    return 4;
+        case irsdk_double:   return 8;
+        default:             return 0;
+    }
+}
+
+int IRSDKLayout::addVar(const char* name, irsdk_VarType type, int count,
+                        const char* unit, const char* desc) {
+    irsdk_varHeader var;
+    var.clear();
+    var.type = type;
+    var.count = std::max(1, count);
+
+    // Keep every value naturally aligned inside the row
+    int size = typeSize(type);
+    var.offset = alignUp(m_bufLen, std::max(1, std::min(size, 8)));
+    m_bufLen = var.offset + size * var.count;
+
+    strncpy(var.name, name, IRSDK_MAX_STRING - 1);
+    strncpy(var.unit, unit, IRSDK_MAX_STRING - 1);
+    strncpy(var.desc, desc, IRSDK_MAX_DESC - 1);
+    m_vars.push_back(var);
+    return var.offset;
+}
+
+int IRSDKLayout::varOffset(const char* name) const {
+    for (const auto& var : m_vars) {
+        if (strncmp(var.name, name, IRSDK_MAX_STRING) == 0) return var.offset;
+    }
+    return -1;
+}
+
+size_t IRSDKLayout::finalize() {
+    m_bufLen = alignUp(std::max(m_bufLen, 4), kRowAlignment);
+
+    // header | varHeaders | session info | rows
+    int varHeaderOffset = alignUp((int)sizeof(irsdk_header), kRowAlignment);
+    int sessionInfoOffset = varHeaderOffset + (int)(m_vars.size() * sizeof(irsdk_varHeader));
+    int firstRow = alignUp(sessionInfoOffset + m_sessionInfoCapacity, 64);
+    m_totalSize = (size_t)firstRow + (size_t)m_bufLen * std::min(m_numBuf, (int)IRSDK_MAX_BUFS);
+    return m_totalSize;
+}
+
+void IRSDKLayout::init(char* mem) const {
+    irsdk_header* header = headerOf(mem);
+    memset(header, 0, sizeof(irsdk_header));
+
+    header->ver = 2;
+    header->tickRate = m_tickRate;
+    header->numVars = (int)m_vars.size();
+    header->varHeaderOffset = alignUp((int)sizeof(irsdk_header), kRowAlignment);
+    header->sessionInfoOffset = header->varHeaderOffset + (int)(m_vars.size() * sizeof(irsdk_varHeader));
+    header->sessionInfoLen = m_sessionInfoCapacity;
+    header->numBuf = std::min(m_numBuf, (int)IRSDK_MAX_BUFS);
+    header->bufLen = m_bufLen;
+
+    int firstRow = alignUp(header->sessionInfoOffset + m_sessionInfoCapacity, 64);
+    for (int i = 0; i < header->numBuf; ++i) {
+        header->varBuf[i].tickCount = -1;
+        header->varBuf[i].bufOffset = firstRow + i * m_bufLen;
+    }
+
+    if (!m_vars.empty()) {
+        memcpy(mem + header->varHeaderOffset, m_vars.data(), m_vars.size() * sizeof(irsdk_varHeader));
+    }
+}
+
+char* IRSDKLayout::rowForTick(char* mem, int tick) {
+    irsdk_header* header = headerOf(mem);
+    return mem + header->varBuf[tick % header->numBuf].bufOffset;
+}
+
+void IRSDKLayout::commitRow(char* mem, int tick) {
+    irsdk_header* header = headerOf(mem);
+    std::atomic_thread_fence(std::memory_order_release);
+    *static_cast<volatile int*>(&header->varBuf[tick % header->numBuf].tickCount) = tick;
+}
+
+bool IRSDKLayout::writeSessionInfo(char* mem, const char* yaml, size_t length) {
+    irsdk_header* header = headerOf(mem);
+    if (length + 1 > (size_t)header->sessionInfoLen) return false;
+
+    char* dst = mem + header->sessionInfoOffset;
+    memcpy(dst, yaml, length);
+    dst[length] = '\0';
+    std::atomic_thread_fence(std::memory_order_release);
+    ++header->sessionInfoUpdate;
+    return true;
+}
+
+void IRSDKLayout::setConnected(char* mem, bool connected) {
+    headerOf(mem)->status = connected ? irsdk_stConnected : 0;
+}
+
+} // namespace iracing
@@ -0,0 +1,54 @@
+#ifndef IRSDK_LAYOUT_H
+#define IRSDK_LAYOUT_H
+
+#include "irsdk/irsdk_defines.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace iracing {
+
+// Writer side of the irsdk memory layout: header, varHeader table, session
+// info string and rotating varBuf rows. Used by local publishers and
+// benchmarks to produce exactly what IRSDKManager expects from the sim.
+class IRSDKLayout {
+public:
+    // Bytes per element for each irsdk_VarType, as in the official SDK
+    static int typeSize(int type);
+
+    // Returns the variable's byte offset inside a row
+    int addVar(const char* name, irsdk_VarType type, int count = 1,
+               const char* unit = "", const char* desc = "");
+
+    void setTickRate(int tickRate) { m_tickRate = tickRate; }
+    void setNumBuf(int numBuf) { m_numBuf = numBuf; }
+    void setSessionInfoCapacity(int bytes) { m_sessionInfoCapacity = bytes; }
+
+    // Computes all offsets; returns the total size of the memory block
+    size_t finalize();
+    size_t totalSize() const { return m_totalSize; }
+    int bufLen() const { return m_bufLen; }
+    int varOffset(const char* name) const;
+
+    // Writes header and varHeader table into a zeroed block of totalSize()
+    void init(char* mem) const;
+
+    // Publishing helpers. Fill rowForTick(), then commitRow() stamps the
+    // tickCount that readers validate against.
+    static char* rowForTick(char* mem, int tick);
+    static void commitRow(char* mem, int tick);
+    static bool writeSessionInfo(char* mem, const char* yaml, size_t length);
+    static void setConnected(char* mem, bool connected);
+
+private:
+    std::vector<irsdk_varHeader> m_vars;
+    int m_tickRate = 60;
+    int m_numBuf = 3;
+    int m_sessionInfoCapacity = 512 * 1024;
+    int m_bufLen = 0;
+    size_t m_totalSize = 0;
+};
+
+} // namespace iracing
+
+#endif // IRSDK_LAYOUT_H
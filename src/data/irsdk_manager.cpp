@@ -1,18 +1,22 @@
 #include "data/irsdk_manager.h"
 #include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 
 namespace iracing {
 
 IRSDKManager::IRSDKManager()
-    : m_hMemMapFile(nullptr),
-      m_hDataValidEvent(nullptr),
+    : m_transport(createSharedMemoryTransport()),
       m_pHeader(nullptr),
       m_pSharedMem(nullptr),
       m_connected(false),
       m_lastTickCount(-1),
-      m_latestBufIndex(-1),
-      m_sessionInfoUpdate(0)
+      m_sessionInfoUpdate(0),
+      m_headerGeneration(0),
+      m_dataVersion(0),
+      m_ingestEnabled(false),
+      m_ingestRunning(false)
 {
 }
 
@@ -20,6 +24,11 @@ IRSDKManager::~IRSDKManager() {
     shutdown();
 }
 
+void IRSDKManager::setTransport(std::unique_ptr<TelemetryTransport> transport) {
+    shutdown();
+    m_transport = std::move(transport);
+}
+
 bool IRSDKManager::startup() {
     if (m_connected && m_pHeader && (m_pHeader->status & irsdk_stConnected)) {
         return true;
@@ -29,11 +38,11 @@ bool IRSDKManager::startup() {
         closeSharedMemory();
         m_connected = false;
         m_lastTickCount = -1;
-        m_latestBufIndex = -1;
     }
 
     if (openSharedMemory()) {
         m_connected = true;
+        if (m_ingestEnabled) startIngestThread();
         return true;
     }
     return false;
@@ -43,7 +52,6 @@ void IRSDKManager::shutdown() {
     closeSharedMemory();
     m_connected = false;
     m_lastTickCount = -1;
-    m_latestBufIndex = -1;
 }
 
 bool IRSDKManager::isConnected() const {
@@ -55,52 +63,91 @@ bool IRSDKManager::isSessionActive() const {
 }
 
 bool IRSDKManager::openSharedMemory() {
-    m_hMemMapFile = OpenFileMapping(FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
-    if (!m_hMemMapFile) {
-        return false;
-    }
-
-    m_pSharedMem = (const char*)MapViewOfFile(m_hMemMapFile, FILE_MAP_READ, 0, 0, 0);
-    if (!m_pSharedMem) {
-        CloseHandle(m_hMemMapFile);
-        m_hMemMapFile = nullptr;
+    if (!m_transport || !m_transport->open()) {
         return false;
     }
 
-    m_pHeader = (const irsdk_header*)m_pSharedMem;
+    m_pSharedMem = m_transport->data();
+    m_pHeader = m_transport->header();
 
     // Version check
-    if (!m_pHeader || m_pHeader->ver < 1) {
-        UnmapViewOfFile(m_pSharedMem);
-        CloseHandle(m_hMemMapFile);
+    if (!m_pHeader || m_pHeader->ver < 1 || !isLayoutValid()) {
+        m_transport->close();
         m_pSharedMem = nullptr;
-        m_hMemMapFile = nullptr;
         m_pHeader = nullptr;
         return false;
     }
 
-    // Try to open the event (optional – we have polling fallback)
-    m_hDataValidEvent = OpenEvent(SYNCHRONIZE, FALSE, IRSDK_DATAVALIDEVENTNAME);
+    // Var headers are fixed for the lifetime of a connection, index them once
+    buildVarIndex();
+    ++m_headerGeneration;
 
     // Read initial buffer so we have data immediately on connect
-    updateLatestBufferIndex();
-    if (m_latestBufIndex >= 0) {
-        m_lastTickCount = m_pHeader->varBuf[m_latestBufIndex].tickCount;
+    m_snapshot.reset();
+    if (captureRow()) {
+        m_lastTickCount = m_snapshot.tickCount();
     }
     m_sessionInfoUpdate = m_pHeader->sessionInfoUpdate;
+    ++m_dataVersion;
 
     return true;
 }
 
+bool IRSDKManager::isLayoutValid() const {
+    // Transports that cannot report their size are trusted as-is
+    const size_t size = m_transport->size();
+    if (size == 0) return true;
+
+    auto fits = [size](long long offset, long long length) {
+        return offset >= 0 && length >= 0 && offset + length <= (long long)size;
+    };
+
+    if (!fits(m_pHeader->varHeaderOffset, (long long)m_pHeader->numVars * sizeof(irsdk_varHeader))) return false;
+    if (!fits(m_pHeader->sessionInfoOffset, m_pHeader->sessionInfoLen)) return false;
+
+    int numBuf = std::min(m_pHeader->numBuf, (int)IRSDK_MAX_BUFS);
+    for (int i = 0; i < numBuf; ++i) {
+        if (!fits(m_pHeader->varBuf[i].bufOffset, m_pHeader->bufLen)) return false;
+    }
+    return true;
+}
+
+bool IRSDKManager::captureRow() {
+    if (!m_transport->hasStableRows()) {
+        return m_snapshot.capture(m_pHeader, m_pSharedMem);
+    }
+
+    // Immutable rows (recorded files) are read in place
+    int tick = -1;
+    int index = TelemetrySnapshot::latestBufIndex(m_pHeader, tick);
+    if (index < 0) return false;
+    m_snapshot.reference(m_transport->row(index), m_pHeader->bufLen, tick);
+    return true;
+}
+
 void IRSDKManager::closeSharedMemory() {
-    if (m_pSharedMem) UnmapViewOfFile(m_pSharedMem);
-    if (m_hMemMapFile) CloseHandle(m_hMemMapFile);
-    if (m_hDataValidEvent) CloseHandle(m_hDataValidEvent);
+    // The ingest thread reads the mapping, stop it before unmapping
+    stopIngestThread();
+    m_recorder.stop();
+
+    if (m_transport) m_transport->close();
 
     m_pSharedMem = nullptr;
-    m_hMemMapFile = nullptr;
-    m_hDataValidEvent = nullptr;
     m_pHeader = nullptr;
+    m_varIndex.clear();
+    m_snapshot.reset();
+    ++m_dataVersion;
+}
+
+bool IRSDKManager::waitForDataValidEvent(int timeoutMS) {
+    // Prefer event when available (low CPU usage)
+    if (m_transport->hasDataValidSignal()) {
+        return m_transport->waitForDataValid(timeoutMS);
+    }
+    if (timeoutMS > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
 }
 
 bool IRSDKManager::waitForData(int timeoutMS) {
@@ -108,26 +155,26 @@ bool IRSDKManager::waitForData(int timeoutMS) {
         return false;
     }
 
-    bool newData = false;
-
-    // Prefer event when available (low CPU usage)
-    if (m_hDataValidEvent) {
-        DWORD result = WaitForSingleObject(m_hDataValidEvent, timeoutMS);
-        if (result == WAIT_OBJECT_0) {
-            newData = true;
-        }
+    // The ingest thread owns the event and the row copies while it runs
+    if (isIngestThreadRunning()) {
+        return consumeLatest();
     }
 
+    bool newData = waitForDataValidEvent(timeoutMS);
+
     // Always double-check with tick count
     int currentTick = getLatestTickCount();
     if (currentTick > m_lastTickCount || m_lastTickCount < 0) {
         newData = true;
     }
 
-    if (newData) {
-        updateLatestBufferIndex();
-        m_lastTickCount = m_pHeader->varBuf[m_latestBufIndex].tickCount;
-        
+    // One validated copy of the whole row per tick; a signal without a new
+    // tick (or a re-read of the same one) does not count as new data
+    if (newData && captureRow() && m_snapshot.tickCount() != m_lastTickCount) {
+        m_lastTickCount = m_snapshot.tickCount();
+        ++m_dataVersion;
+        feedRecorder(m_snapshot.data(), m_lastTickCount);
+
         // Check if session info was updated
         if (m_pHeader->sessionInfoUpdate != m_sessionInfoUpdate) {
             m_sessionInfoUpdate = m_pHeader->sessionInfoUpdate;
@@ -138,8 +185,7 @@ bool IRSDKManager::waitForData(int timeoutMS) {
     return false;
 }
 
-// FIXED: Added missing update() implementation
-void IRSDKManager::update() {
+bool IRSDKManager::updateConnection() {
     // Try to connect if not already connected
     if (!m_connected) {
         startup();
@@ -152,125 +198,297 @@ void IRSDKManager::update() {
             closeSharedMemory();
             m_connected = false;
             m_lastTickCount = -1;
-            m_latestBufIndex = -1;
-            return;
+            return false;
         }
+        return true;
+    }
+    return false;
+}
+
+// FIXED: Added missing update() implementation
+void IRSDKManager::update() {
+    if (updateConnection()) {
         // Non-blocking poll for new data
         waitForData(0);
     }
 }
 
-void IRSDKManager::updateLatestBufferIndex() {
-    int numBuf = std::min(m_pHeader->numBuf, (int)IRSDK_MAX_BUFS);
-    m_latestBufIndex = 0;
-    int maxTick = m_pHeader->varBuf[0].tickCount;
+void IRSDKManager::setIngestThreadEnabled(bool enabled) {
+    m_ingestEnabled = enabled;
+    if (!enabled) {
+        stopIngestThread();
+    } else if (m_connected && m_pHeader) {
+        startIngestThread();
+    }
+}
+
+SnapshotRing::Stats IRSDKManager::getIngestStats() const {
+    return m_ingestRing ? m_ingestRing->stats() : SnapshotRing::Stats();
+}
+
+bool IRSDKManager::startRecording(const std::string& path) {
+    if (!m_connected || !m_pHeader) return false;
+    return m_recorder.start(path, m_pHeader, m_pSharedMem);
+}
+
+void IRSDKManager::stopRecording() {
+    m_recorder.stop();
+}
+
+// Runs on whichever thread captures rows (ingest thread or update())
+void IRSDKManager::feedRecorder(const char* row, int tickCount) {
+    if (!m_recorder.isRecording()) return;
+
+    int update = m_pHeader->sessionInfoUpdate;
+    if (m_recorder.needsSessionInfo(update)) {
+        m_recorder.pushSessionInfo(getSessionInfo(), getSessionInfoLength(), update);
+    }
+    m_recorder.pushRow(row, m_pHeader->bufLen, tickCount, update);
+}
+
+void IRSDKManager::startIngestThread() {
+    if (isIngestThreadRunning() || !m_pHeader || m_pHeader->bufLen <= 0) return;
+
+    // Stable rows are already buffered by their source, nothing to ingest
+    if (m_transport->hasStableRows()) return;
 
-    for (int i = 1; i < numBuf; ++i) {
-        if (m_pHeader->varBuf[i].tickCount > maxTick) {
-            maxTick = m_pHeader->varBuf[i].tickCount;
-            m_latestBufIndex = i;
+    m_ingestRing = std::make_unique<SnapshotRing>(kIngestRingSlots, m_pHeader->bufLen);
+    m_ingestRunning.store(true, std::memory_order_release);
+    m_ingestThread = std::thread(&IRSDKManager::ingestLoop, this);
+}
+
+void IRSDKManager::stopIngestThread() {
+    if (!isIngestThreadRunning()) return;
+
+    m_ingestRunning.store(false, std::memory_order_release);
+    m_ingestThread.join();
+
+    // Ring is kept so the final counters stay readable until the next start
+    SnapshotRing::Stats stats = m_ingestRing->stats();
+    std::cout << "[IRSDK] Ingest stopped: produced=" << stats.produced
+              << " consumed=" << stats.consumed << " dropped=" << stats.dropped
+              << " missed=" << stats.missed << "\n";
+}
+
+void IRSDKManager::ingestLoop() {
+    int lastTick = m_lastTickCount;
+
+    while (m_ingestRunning.load(std::memory_order_acquire)) {
+        waitForDataValidEvent(kIngestWaitMS);
+
+        int tick = getLatestTickCount();
+        if (tick < 0 || tick == lastTick) continue;
+
+        SnapshotRing::Slot* slot = m_ingestRing->acquireWrite();
+        if (!slot) {
+            // Ring full: the render thread is stalled, this tick is lost
+            lastTick = tick;
+            continue;
         }
+
+        int copiedTick = -1;
+        if (!TelemetrySnapshot::copyLatestRow(m_pHeader, m_pSharedMem, slot->data, copiedTick)) {
+            continue;
+        }
+
+        if (lastTick >= 0 && copiedTick > lastTick + 1) {
+            m_ingestRing->addMissed(static_cast<uint64_t>(copiedTick - lastTick - 1));
+        }
+
+        slot->size = m_pHeader->bufLen;
+        slot->tickCount = copiedTick;
+        slot->sessionInfoUpdate = m_pHeader->sessionInfoUpdate;
+        feedRecorder(slot->data, copiedTick);
+        m_ingestRing->commitWrite();
+        lastTick = copiedTick;
     }
 }
 
+bool IRSDKManager::consumeLatest() {
+    const SnapshotRing::Slot* slot = m_ingestRing->peekLatest();
+    if (!slot) return false;
+
+    adoptSlot(*slot);
+    m_ingestRing->pop();
+    return true;
+}
+
+void IRSDKManager::adoptSlot(const SnapshotRing::Slot& slot) {
+    m_snapshot.assign(slot.data, slot.size, slot.tickCount);
+    ++m_dataVersion;
+    m_lastTickCount = slot.tickCount;
+    m_sessionInfoUpdate = slot.sessionInfoUpdate;
+}
+
 int IRSDKManager::getLatestTickCount() const {
-    if (!m_pHeader) return -1;
-    int numBuf = std::min(m_pHeader->numBuf, (int)IRSDK_MAX_BUFS);
     int maxTick = -1;
-    for (int i = 0; i < numBuf; ++i) {
-        maxTick = std::max(maxTick, m_pHeader->varBuf[i].tickCount);
-    }
+    TelemetrySnapshot::latestBufIndex(m_pHeader, maxTick);
     return maxTick;
 }
 
 const char* IRSDKManager::getDataPtr() const {
-    if (!m_pHeader || m_latestBufIndex < 0) return nullptr;
-    return m_pSharedMem + m_pHeader->varBuf[m_latestBufIndex].bufOffset;
+    if (!m_pHeader) return nullptr;
+    return m_snapshot.data();
 }
 
-const irsdk_varHeader* IRSDKManager::getVarHeader(const char* name) const {
-    if (!m_pHeader) return nullptr;
+unsigned int IRSDKManager::hashVarName(const char* name) {
+    // FNV-1a, bounded by the fixed-size name field of irsdk_varHeader
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < IRSDK_MAX_STRING && name[i]; ++i) {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void IRSDKManager::buildVarIndex() {
+    m_varIndex.clear();
+    if (!m_pHeader || m_pHeader->numVars <= 0) return;
+
+    // Power-of-two table kept at most half full so probe chains stay short
+    size_t size = 64;
+    while (size < static_cast<size_t>(m_pHeader->numVars) * 2) size <<= 1;
+    m_varIndex.assign(size, 0);
 
     const auto* headers = reinterpret_cast<const irsdk_varHeader*>(
         m_pSharedMem + m_pHeader->varHeaderOffset);
+    const size_t mask = size - 1;
 
     for (int i = 0; i < m_pHeader->numVars; ++i) {
-        if (strcmp(headers[i].name, name) == 0) {
-            return &headers[i];
+        size_t slot = hashVarName(headers[i].name) & mask;
+        while (m_varIndex[slot] != 0) slot = (slot + 1) & mask;
+        m_varIndex[slot] = i + 1;
+    }
+}
+
+const irsdk_varHeader* IRSDKManager::getVarHeader(const char* name) const {
+    if (!m_pHeader || !name || m_varIndex.empty()) return nullptr;
+
+    const auto* headers = reinterpret_cast<const irsdk_varHeader*>(
+        m_pSharedMem + m_pHeader->varHeaderOffset);
+    const size_t mask = m_varIndex.size() - 1;
+
+    for (size_t slot = hashVarName(name) & mask; m_varIndex[slot] != 0; slot = (slot + 1) & mask) {
+        const irsdk_varHeader& header = headers[m_varIndex[slot] - 1];
+        if (strncmp(header.name, name, IRSDK_MAX_STRING) == 0) {
+            return &header;
         }
     }
     return nullptr;
 }
 
-float IRSDKManager::getFloat(const char* name, float defaultValue) const {
+VarHandle IRSDKManager::getVarHandle(const char* name) const {
+    VarHandle var;
     const auto* header = getVarHeader(name);
-    if (!header || (header->type != irsdk_float && header->type != irsdk_double)) {
+    if (header) {
+        var.offset = header->offset;
+        var.type = header->type;
+        var.count = header->count;
+    }
+    return var;
+}
+
+float IRSDKManager::getFloat(const char* name, float defaultValue) const {
+    return getFloat(getVarHandle(name), defaultValue);
+}
+
+int IRSDKManager::getInt(const char* name, int defaultValue) const {
+    return getInt(getVarHandle(name), defaultValue);
+}
+
+bool IRSDKManager::getBool(const char* name, bool defaultValue) const {
+    return getBool(getVarHandle(name), defaultValue);
+}
+
+const float* IRSDKManager::getFloatArray(const char* name, int& count) const {
+    return getFloatArray(getVarHandle(name), count);
+}
+
+const int* IRSDKManager::getIntArray(const char* name, int& count) const {
+    return getIntArray(getVarHandle(name), count);
+}
+
+const bool* IRSDKManager::getBoolArray(const char* name, int& count) const {
+    return getBoolArray(getVarHandle(name), count);
+}
+
+float IRSDKManager::getFloat(const VarHandle& var, float defaultValue) const {
+    if (!var.isValid() || (var.type != irsdk_float && var.type != irsdk_double)) {
         return defaultValue;
     }
 
     const char* data = getDataPtr();
     if (!data) return defaultValue;
 
-    // Torn-read check: verify tick hasn't changed during read
-    int tickBefore = m_pHeader->varBuf[m_latestBufIndex].tickCount;
-    float value = (header->type == irsdk_double)
-        ? static_cast<float>(*(const double*)(data + header->offset))
-        : *(const float*)(data + header->offset);
-    int tickAfter = m_pHeader->varBuf[m_latestBufIndex].tickCount;
-
-    return (tickBefore == tickAfter) ? value : defaultValue;
+    // Snapshot rows are private and validated, no per-read torn check needed
+    return (var.type == irsdk_double)
+        ? static_cast<float>(*(const double*)(data + var.offset))
+        : *(const float*)(data + var.offset);
 }
 
-int IRSDKManager::getInt(const char* name, int defaultValue) const {
-    const auto* header = getVarHeader(name);
-    if (!header || (header->type != irsdk_int && header->type != irsdk_bool && header->type != irsdk_bitField)) {
+int IRSDKManager::getInt(const VarHandle& var, int defaultValue) const {
+    if (!var.isValid() || (var.type != irsdk_int && var.type != irsdk_bool && var.type != irsdk_bitField)) {
         return defaultValue;
     }
 
     const char* data = getDataPtr();
     if (!data) return defaultValue;
 
-    int tickBefore = m_pHeader->varBuf[m_latestBufIndex].tickCount;
-    int value = *(const int*)(data + header->offset);
-    int tickAfter = m_pHeader->varBuf[m_latestBufIndex].tickCount;
+    // irsdk_bool is a single byte in the row, not an int
+    if (var.type == irsdk_bool) return data[var.offset] != 0 ? 1 : 0;
+    return *(const int*)(data + var.offset);
+}
 
-    return (tickBefore == tickAfter) ? value : defaultValue;
+bool IRSDKManager::getBool(const VarHandle& var, bool defaultValue) const {
+    return getInt(var, defaultValue ? 1 : 0) != 0;
 }
 
-bool IRSDKManager::getBool(const char* name, bool defaultValue) const {
-    return getInt(name, defaultValue ? 1 : 0) != 0;
+double IRSDKManager::getDouble(const VarHandle& var, double defaultValue) const {
+    if (!var.isValid() || (var.type != irsdk_float && var.type != irsdk_double)) {
+        return defaultValue;
+    }
+
+    const char* data = getDataPtr();
+    if (!data) return defaultValue;
+
+    return (var.type == irsdk_double)
+        ? *(const double*)(data + var.offset)
+        : static_cast<double>(*(const float*)(data + var.offset));
 }
 
-const float* IRSDKManager::getFloatArray(const char* name, int& count) const {
+const float* IRSDKManager::getFloatArray(const VarHandle& var, int& count) const {
     count = 0;
-    const auto* header = getVarHeader(name);
-    if (!header || header->type != irsdk_float) return nullptr;
+    if (!var.isValid() || var.type != irsdk_float) return nullptr;
 
-    count = header->count;
     const char* data = getDataPtr();
-    if (!data) {
-        count = 0;
-        return nullptr;
-    }
+    if (!data) return nullptr;
 
-    return reinterpret_cast<const float*>(data + header->offset);
+    count = var.count;
+    return reinterpret_cast<const float*>(data + var.offset);
 }
 
-const int* IRSDKManager::getIntArray(const char* name, int& count) const {
+const int* IRSDKManager::getIntArray(const VarHandle& var, int& count) const {
     count = 0;
-    const auto* header = getVarHeader(name);
-    if (!header || (header->type != irsdk_int && header->type != irsdk_bool && header->type != irsdk_bitField)) {
+    if (!var.isValid() || (var.type != irsdk_int && var.type != irsdk_bitField)) {
         return nullptr;
     }
 
-    count = header->count;
     const char* data = getDataPtr();
-    if (!data) {
-        count = 0;
-        return nullptr;
-    }
+    if (!data) return nullptr;
+
+    count = var.count;
+    return reinterpret_cast<const int*>(data + var.offset);
+}
+
+const bool* IRSDKManager::getBoolArray(const VarHandle& var, int& count) const {
+    count = 0;
+    if (!var.isValid() || var.type != irsdk_bool) return nullptr;
 
-    return reinterpret_cast<const int*>(data + header->offset);
+    const char* data = getDataPtr();
+    if (!data) return nullptr;
+
+    count = var.count;
+    return reinterpret_cast<const bool*>(data + var.offset);
 }
 
 const char* IRSDKManager::getSessionInfo() const {
@@ -278,8 +496,33 @@ const char* IRSDKManager::getSessionInfo() const {
     return m_pSharedMem + m_pHeader->sessionInfoOffset;
 }
 
+size_t IRSDKManager::getSessionInfoLength() const {
+    if (!m_pHeader || m_pHeader->sessionInfoLen <= 0) return 0;
+    const char* info = m_pSharedMem + m_pHeader->sessionInfoOffset;
+    return strnlen(info, (size_t)m_pHeader->sessionInfoLen);
+}
+
 int IRSDKManager::getSessionInfoUpdate() const {
     return m_pHeader ? m_pHeader->sessionInfoUpdate : 0;
 }
 
+bool IRSDKManager::copySessionInfo(std::string& out, int& update) const {
+    if (!m_pHeader) return false;
+
+    // Same idea as the row seqlock: a rewrite that lands while copying
+    // bumps the counter, so the copy is retried
+    const volatile int* counter = &m_pHeader->sessionInfoUpdate;
+    for (int attempt = 0; attempt < TelemetrySnapshot::kMaxCaptureRetries; ++attempt) {
+        const int before = *counter;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        out.assign(getSessionInfo(), getSessionInfoLength());
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (*counter == before) {
+            update = before;
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace iracing
\ No newline at end of file
@@ -1,16 +1,40 @@
 #ifndef IRSDK_MANAGER_H
 #define IRSDK_MANAGER_H
 
-#include <windows.h>
 #include "irsdk/irsdk_defines.h"
+#include "data/telemetry_snapshot.h"
+#include "data/telemetry_transport.h"
+#include "data/snapshot_ring.h"
+#include "data/telemetry_recorder.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace iracing {
 
+// Resolved location of a telemetry variable inside a varBuf row.
+// Resolve once with IRSDKManager::getVarHandle() and re-resolve whenever
+// IRSDKManager::getHeaderGeneration() changes (new connection).
+struct VarHandle {
+    int offset = -1;
+    int type = -1;
+    int count = 0;
+
+    bool isValid() const { return offset >= 0; }
+};
+
 class IRSDKManager {
 public:
     IRSDKManager();
     ~IRSDKManager();
 
+    // Replace the data source (default: the platform shared memory).
+    // Disconnects first; the next update() connects through the new one.
+    void setTransport(std::unique_ptr<TelemetryTransport> transport);
+    TelemetryTransport* getTransport() const { return m_transport.get(); }
+
     // Connection
     bool startup();
     void shutdown();
@@ -20,42 +44,136 @@ public:
     // Data access
     bool waitForData(int timeoutMS = 16);
     void update();  // ADDED: Update method to poll for data
+
+    // Same as update(), but processes every tick ingested since the last
+    // call in order. onTick() runs once per tick with the getters reading
+    // that tick's row. Returns the number of ticks processed.
+    template<typename Fn>
+    int update(Fn&& onTick);
+
+    // Background ingestion: a dedicated thread waits for the data-valid
+    // event and copies every tick into a lock-free ring that update()
+    // consumes, so sampling no longer depends on the render rate.
+    void setIngestThreadEnabled(bool enabled);
+    bool isIngestThreadRunning() const { return m_ingestThread.joinable(); }
+    SnapshotRing::Stats getIngestStats() const;
+
+    // Record every ingested tick (plus session info changes) to a file.
+    // Requires a connection; recording stops on disconnect.
+    bool startRecording(const std::string& path);
+    void stopRecording();
+    bool isRecording() const { return m_recorder.isRecording(); }
+    TelemetryRecorder::Stats getRecordingStats() const { return m_recorder.stats(); }
     
+    // Bumped whenever the row the getters read changes (new tick, connect,
+    // disconnect). Consumers compare it to skip work when nothing changed.
+    uint64_t getDataVersion() const { return m_dataVersion; }
+
+    // Variable handles
+    VarHandle getVarHandle(const char* name) const;
+    int getHeaderGeneration() const { return m_headerGeneration; }
+
     // Get values
     float getFloat(const char* name, float defaultValue = 0.0f) const;
     int getInt(const char* name, int defaultValue = 0) const;
     bool getBool(const char* name, bool defaultValue = false) const;
+
+    float getFloat(const VarHandle& var, float defaultValue = 0.0f) const;
+    int getInt(const VarHandle& var, int defaultValue = 0) const;
+    bool getBool(const VarHandle& var, bool defaultValue = false) const;
+    // Full precision for irsdk_double (SessionTime); floats are widened
+    double getDouble(const VarHandle& var, double defaultValue = 0.0) const;
     
     // Array access
     const float* getFloatArray(const char* name, int& count) const;
     const int* getIntArray(const char* name, int& count) const;
+    const bool* getBoolArray(const char* name, int& count) const;
+
+    const float* getFloatArray(const VarHandle& var, int& count) const;
+    const int* getIntArray(const VarHandle& var, int& count) const;
+    const bool* getBoolArray(const VarHandle& var, int& count) const;  // 1 byte per entry
     
+    // Row captured by the last update(); all getters read from it
+    const TelemetrySnapshot& getSnapshot() const { return m_snapshot; }
+
     // Session info
     const char* getSessionInfo() const;
+    size_t getSessionInfoLength() const;  // may not be NUL-terminated (.ibt files)
     int getSessionInfoUpdate() const;
+    // Copies the session string into out (reusing its capacity), retrying
+    // while the sim rewrites it. update is the counter the copy belongs to.
+    bool copySessionInfo(std::string& out, int& update) const;
 
     // Generic template (kept for future use)
     template<typename T>
     T getVar(const char* name, T defaultValue = T());
 
 private:
+    static constexpr int kIngestRingSlots = 64;
+    static constexpr int kIngestWaitMS = 16;
+
+    bool updateConnection();
     bool openSharedMemory();
     void closeSharedMemory();
-    void updateLatestBufferIndex();
+    bool isLayoutValid() const;
+    bool captureRow();
     int getLatestTickCount() const;
     const char* getDataPtr() const;
     const irsdk_varHeader* getVarHeader(const char* name) const;
+    bool waitForDataValidEvent(int timeoutMS);
+
+    void startIngestThread();
+    void stopIngestThread();
+    void ingestLoop();
+    bool consumeLatest();
+    void adoptSlot(const SnapshotRing::Slot& slot);
+    void feedRecorder(const char* row, int tickCount);
+    void buildVarIndex();
+    static unsigned int hashVarName(const char* name);
     
-    HANDLE m_hMemMapFile;
-    HANDLE m_hDataValidEvent;
+    std::unique_ptr<TelemetryTransport> m_transport;
     const irsdk_header* m_pHeader;
     const char* m_pSharedMem;
     bool m_connected;
     int m_lastTickCount;
-    int m_latestBufIndex;
     int m_sessionInfoUpdate;
+    int m_headerGeneration;
+    uint64_t m_dataVersion;
+    TelemetrySnapshot m_snapshot;
+
+    // Open-addressing hash of var name -> varHeader index + 1 (0 = empty slot)
+    std::vector<int> m_varIndex;
+
+    // Ingest thread state; the mapping outlives the thread, which is
+    // always joined before closeSharedMemory() releases it
+    bool m_ingestEnabled;
+    std::atomic<bool> m_ingestRunning;
+    std::thread m_ingestThread;
+    std::unique_ptr<SnapshotRing> m_ingestRing;
+
+    TelemetryRecorder m_recorder;
 };
 
+template<typename Fn>
+int IRSDKManager::update(Fn&& onTick) {
+    if (!updateConnection()) return 0;
+
+    if (!isIngestThreadRunning()) {
+        if (!waitForData(0)) return 0;
+        onTick();
+        return 1;
+    }
+
+    int count = 0;
+    while (const SnapshotRing::Slot* slot = m_ingestRing->peek()) {
+        adoptSlot(*slot);
+        m_ingestRing->pop();
+        onTick();
+        ++count;
+    }
+    return count;
+}
+
 } // namespace iracing
 
 #endif // IRSDK_MANAGER_H
\ No newline at end of file
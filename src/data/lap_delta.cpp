@@ -0,0 +1,239 @@
+#include "data/lap_delta.h"
+#include "data/lap_step.h"
+#include "utils/mapped_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace iracing {
+
+namespace {
+
+constexpr char kMagic[4] = { 'I', 'R', 'L', 'D' };
+constexpr std::chrono::milliseconds kSavePoll(250);  // longest a new reference waits
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t bins;
+    float lapTime;
+};
+static_assert(sizeof(FileHeader) == 16, "FileHeader is written as is");
+
+} // namespace
+
+LapDelta::LapDelta() {
+    std::fill(m_reference, m_reference + kBins + 1, 0.0f);
+    std::fill(m_current, m_current + kBins + 1, 0.0f);
+}
+
+LapDelta::~LapDelta() {
+    if (!m_saver.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        m_saveStop = true;
+    }
+    m_saveWake.notify_one();
+    m_saver.join();
+}
+
+bool LapDelta::open(const std::string& path) {
+    // A save still pending may be the file about to be loaded
+    flush();
+    if (!path.empty() && !m_saver.joinable()) m_saver = std::thread(&LapDelta::runSaver, this);
+    m_path = path;
+    std::fill(m_reference, m_reference + kBins + 1, 0.0f);
+    reset();
+    return !m_path.empty() && load();
+}
+
+void LapDelta::reset() {
+    m_valid = false;
+    m_timing = false;
+    m_clean = false;
+    m_hasDelta = false;
+    m_time = 0.0;
+}
+
+void LapDelta::update(const CarFrame& f, int car, double now) {
+    if (car < 0 || car >= f.carCount || !f.isInWorld(car) || f.lapDistPct[car] < 0.0f || now < m_time) {
+        reset();
+        return;
+    }
+    const float pct = f.lapDistPct[car] >= 1.0f ? 0.0f : f.lapDistPct[car];
+    if (!m_valid) {
+        m_valid = true;
+        m_pct = pct;
+        m_time = now;
+        return;
+    }
+
+    const LapStep step(m_pct, pct);
+    if (step.kind == LapStep::Jump) {
+        // Tow, reset or teleport: the next line crossing starts over
+        m_timing = false;
+        m_hasDelta = false;
+        m_pct = pct;
+        m_time = now;
+        return;
+    }
+    if (step.kind == LapStep::Forward) {
+        // Bins b / kBins passed since the previous tick
+        LapSpan(m_pct, step, m_time, now, kBins).forEachBoundary([&](int b, double at) {
+            const int bin = b % kBins;
+            if (bin == 0) {
+                finishLap(at);
+            } else if (m_timing) {
+                m_current[bin] = (float)(at - m_lapStart);
+            }
+        });
+        m_pct = pct;
+        m_time = now;
+    }
+    if (f.onPitRoad[car]) m_clean = false;
+
+    m_hasDelta = m_timing && hasReference();
+    if (m_hasDelta) {
+        const float x = m_pct * kBins;
+        const int bin = std::min((int)x, kBins - 1);
+        const float ref = m_reference[bin] + (m_reference[bin + 1] - m_reference[bin]) * (x - bin);
+        m_delta = (float)(now - m_lapStart) - ref;
+    }
+}
+
+void LapDelta::finishLap(double at) {
+    if (m_timing && m_clean) {
+        const float lapTime = (float)(at - m_lapStart);
+        if (lapTime > 0.0f && (!hasReference() || lapTime < m_reference[kBins])) {
+            m_current[0] = 0.0f;
+            m_current[kBins] = lapTime;
+            std::copy(m_current, m_current + kBins + 1, m_reference);
+            if (!m_path.empty()) {
+                std::lock_guard<std::mutex> lock(m_saveMutex);
+                m_savePath = m_path;
+                std::copy(m_reference, m_reference + kBins + 1, m_saveTimes);
+                m_hasSave = true;
+            }
+        }
+    }
+    m_timing = true;
+    m_clean = true;
+    m_lapStart = at;
+}
+
+bool LapDelta::delta(float& seconds) const {
+    if (!m_hasDelta) return false;
+    seconds = m_delta;
+    return true;
+}
+
+bool LapDelta::predictedLapTime(float& seconds) const {
+    if (!m_hasDelta) return false;
+    seconds = m_reference[kBins] + m_delta;
+    return true;
+}
+
+bool LapDelta::load() {
+    utils::MappedFile file;
+    if (!file.open(m_path)) return false;
+
+    const size_t expected = sizeof(FileHeader) + sizeof(float) * (kBins + 1);
+    FileHeader header;
+    if (file.size() != expected) return false;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.bins != kBins) {
+        std::cerr << "[LapDelta] Ignoring incompatible reference: " << m_path << std::endl;
+        return false;
+    }
+
+    float times[kBins + 1];
+    memcpy(times, file.data() + sizeof(header), sizeof(times));
+    bool ordered = times[0] == 0.0f && times[kBins] == header.lapTime && header.lapTime > 0.0f;
+    for (int b = 1; b <= kBins && ordered; ++b) ordered = times[b] >= times[b - 1];
+    if (!ordered) {
+        std::cerr << "[LapDelta] Ignoring damaged reference: " << m_path << std::endl;
+        return false;
+    }
+    std::copy(times, times + kBins + 1, m_reference);
+    std::cout << "[LapDelta] Loaded reference lap " << header.lapTime << " s from " << m_path << std::endl;
+    return true;
+}
+
+void LapDelta::flush() {
+    m_saveWake.notify_one();
+    std::unique_lock<std::mutex> lock(m_saveMutex);
+    m_saveDone.wait(lock, [this] { return !m_hasSave && !m_saving; });
+}
+
+void LapDelta::runSaver() {
+    std::string path;
+    float times[kBins + 1];
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_saveMutex);
+            if (m_saving) {
+                m_saving = false;
+                m_saveDone.notify_all();
+            }
+            // Polled, not notified by finishLap(): on a busy core the
+            // wakeup hands the saver the render thread's time slice
+            // until the file is written
+            m_saveWake.wait_for(lock, kSavePoll, [this] { return m_saveStop || m_hasSave; });
+            if (!m_hasSave) {
+                if (m_saveStop) return;
+                continue;
+            }
+            path.swap(m_savePath);
+            std::copy(m_saveTimes, m_saveTimes + kBins + 1, times);
+            m_hasSave = false;
+            m_saving = true;
+        }
+        save(path, times);
+    }
+}
+
+bool LapDelta::save(const std::string& path, const float* times) {
+    // Written beside the target and renamed over it, so a reader never
+    // sees half a file
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const fs::path target(path);
+    if (target.has_parent_path()) fs::create_directories(target.parent_path(), ec);
+
+    const std::string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        std::cerr << "[LapDelta] Failed to save: " << path << std::endl;
+        return false;
+    }
+    FileHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.bins = kBins;
+    header.lapTime = times[kBins];
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = fwrite(times, sizeof(float), kBins + 1, file) == (size_t)(kBins + 1) && ok;
+    ok = fclose(file) == 0 && ok;
+    if (ok) fs::rename(temp, target, ec);
+    if (!ok || ec) {
+        std::cerr << "[LapDelta] Failed to save: " << path << std::endl;
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::string LapDelta::fileName(const std::string& track, const std::string& car) {
+    std::string name = track + "__" + car;
+    for (char& c : name) {
+        const bool keep = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-';
+        if (!keep) c = '_';
+    }
+    return name + ".lapref";
+}
+
+} // namespace iracing
@@ -0,0 +1,98 @@
+#ifndef LAP_DELTA_H
+#define LAP_DELTA_H
+
+#include "data/car_frame.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace iracing {
+
+// Live delta of one car (the player) to a reference lap. The reference is
+// the time into the lap at each of kBins equal steps of lap distance; the
+// lap in progress records the same as it goes (crossings interpolated
+// between ticks), and the delta is the time so far minus the reference
+// interpolated at the current position. A clean lap (timed from the line,
+// no pit road, no jump) faster than the reference replaces it.
+//
+// References persist per car and track as small binary files:
+//   "IRLD" u32 version  i32 bins  f32 lapTime  f32 time[bins + 1]
+// loaded through a read-only mapping and copied out, so the file can be
+// replaced while the overlay runs. A new reference is copied into a
+// pending buffer that a saver thread (started by the first open() with a
+// path) polls for and writes, so update() never waits on the disk.
+class LapDelta {
+public:
+    static constexpr int kBins = 1000;
+    static constexpr uint32_t kVersion = 1;
+
+    LapDelta();
+    ~LapDelta();
+
+    LapDelta(const LapDelta&) = delete;
+    LapDelta& operator=(const LapDelta&) = delete;
+
+    // Reference file for the car/track; an empty path keeps the reference
+    // in memory only. Loads the file when it holds a valid reference, else
+    // starts without one. Drops the lap in progress either way.
+    bool open(const std::string& path);
+    const std::string& path() const { return m_path; }
+
+    // Blocks until the last reference handed to the saver is written
+    void flush();
+
+    // Drops the lap in progress, keeps the reference (reconnect, seek)
+    void reset();
+
+    // O(1) per tick: the bins car passed since the previous frame
+    void update(const CarFrame& frame, int carIdx, double sessionTime);
+
+    bool hasReference() const { return m_reference[kBins] > 0.0f; }
+    float referenceLapTime() const { return m_reference[kBins]; }
+
+    // Seconds behind the reference at the current position (negative when
+    // ahead) and the lap time that gives; false without a reference or a
+    // lap timed from the line
+    bool delta(float& seconds) const;
+    bool predictedLapTime(float& seconds) const;
+
+    // Reference file name for a car/track pair; anything but [A-Za-z0-9-]
+    // becomes '_'
+    static std::string fileName(const std::string& track, const std::string& car);
+
+private:
+    bool load();
+    static bool save(const std::string& path, const float* times);
+    void finishLap(double at);
+    void runSaver();
+
+    std::string m_path;
+    float m_reference[kBins + 1];  // seconds into the lap at bin b, [kBins] = lap time
+    float m_current[kBins + 1];
+
+    bool m_valid = false;      // car seen on the previous update
+    bool m_timing = false;     // lap in progress timed from the line
+    bool m_clean = false;      // and neither on pit road nor jumped since
+    float m_pct = 0.0f;
+    double m_time = 0.0;
+    double m_lapStart = 0.0;
+    float m_delta = 0.0f;
+    bool m_hasDelta = false;
+
+    // Pending save, latest wins
+    std::thread m_saver;
+    std::mutex m_saveMutex;
+    std::condition_variable m_saveWake;
+    std::condition_variable m_saveDone;
+    bool m_saveStop = false;
+    bool m_hasSave = false;
+    bool m_saving = false;
+    std::string m_savePath;
+    float m_saveTimes[kBins + 1];
+};
+
+} // namespace iracing
+
+#endif // LAP_DELTA_H
@@ -0,0 +1,136 @@
+#include "data/lap_history.h"
+#include <algorithm>
+#include <cmath>
+
+namespace iracing {
+
+LapHistory::LapHistory()
+    : m_laps((size_t)CarFrame::kMaxCars * kLaps)
+{
+}
+
+void LapHistory::reset() {
+    for (Car& car : m_cars) car = Car();
+    m_now = 0.0;
+}
+
+void LapHistory::update(const CarFrame& f, double now) {
+    if (now < m_now) reset();
+    m_now = now;
+
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        Car& car = m_cars[i];
+        if (i >= f.carCount || !f.isInWorld(i)) {
+            // Laps stay; tracking starts over when the car is back
+            if (car.pending) commit(i, car.pendingLap.time);
+            car.valid = false;
+            continue;
+        }
+        const int completed = f.lapCompleted[i];
+        const float pct = std::clamp(f.lapDistPct[i], 0.0f, 1.0f);
+        const float lastLap = f.lastLapTime[i];
+        const bool onPit = f.onPitRoad[i] != 0;
+
+        if (completed < car.lapCompleted) car = Car();  // lap count went down: a new session
+        if (!car.valid) {
+            car.valid = true;
+            car.lapCompleted = completed;
+            car.pct = pct;
+            car.time = now;
+            car.lastLapTime = lastLap;
+            car.crossing = -1.0;
+            car.lapPit = onPit;
+            continue;
+        }
+
+        if (completed > car.lapCompleted) {
+            if (car.pending) commit(i, car.pendingLap.time);
+            // Crossing interpolated between this tick and the previous one
+            double crossing = now;
+            const float step = pct + 1.0f - car.pct;
+            if (car.pct >= 0.5f && pct < 0.5f && step > 0.0f) {
+                crossing = car.time + (now - car.time) * (1.0f - car.pct) / step;
+            }
+            Lap& lap = car.pendingLap;
+            lap.sessionTime = crossing;
+            lap.lap = (int16_t)completed;
+            lap.pit = car.lapPit || onPit;
+            // Line to line only for a lap seen whole
+            const bool whole = completed == car.lapCompleted + 1 && car.crossing >= 0.0;
+            lap.time = whole ? (float)(crossing - car.crossing) : -1.0f;
+            car.pending = true;
+            car.lastLapBefore = car.lastLapTime;
+            car.crossing = crossing;
+            car.lapCompleted = completed;
+            car.lapPit = onPit;
+        } else {
+            car.lapPit = car.lapPit || onPit;
+        }
+
+        if (car.pending) {
+            if (lastLap > 0.0f && lastLap != car.lastLapBefore) {
+                commit(i, lastLap);
+            } else if (now - car.pendingLap.sessionTime >= kOfficialWait) {
+                commit(i, car.pendingLap.time);
+            }
+        }
+        car.pct = pct;
+        car.time = now;
+        car.lastLapTime = lastLap;
+    }
+}
+
+void LapHistory::commit(int i, float time) {
+    Car& car = m_cars[i];
+    car.pending = false;
+    Lap lap = car.pendingLap;
+    lap.time = time > 0.0f ? time : -1.0f;
+
+    Lap& slot = ring(i)[car.head];
+    if (car.count == kLaps && slot.clean()) {
+        car.sum -= slot.time;
+        car.sumSquares -= (double)slot.time * slot.time;
+        --car.clean;
+    }
+    slot = lap;
+    car.head = (car.head + 1) % kLaps;
+    car.count = std::min(car.count + 1, kLaps);
+    if (lap.clean()) {
+        car.sum += lap.time;
+        car.sumSquares += (double)lap.time * lap.time;
+        ++car.clean;
+        if (car.best < 0.0f || lap.time < car.best) car.best = lap.time;
+    }
+    // Drops the rounding left over from removed laps
+    if (car.clean == 0) car.sum = car.sumSquares = 0.0;
+}
+
+int LapHistory::count(int car) const {
+    return (car >= 0 && car < CarFrame::kMaxCars) ? m_cars[car].count : 0;
+}
+
+const LapHistory::Lap& LapHistory::recent(int car, int n) const {
+    return ring(car)[(m_cars[car].head - 1 - n + 2 * kLaps) % kLaps];
+}
+
+int LapHistory::recentLaps(int car, Lap* out, int maxLaps) const {
+    const int n = std::min(count(car), maxLaps);
+    for (int k = 0; k < n; ++k) out[k] = recent(car, k);
+    return n;
+}
+
+LapHistory::Stats LapHistory::stats(int i) const {
+    Stats s;
+    if (i < 0 || i >= CarFrame::kMaxCars) return s;
+    const Car& car = m_cars[i];
+    s.laps = car.clean;
+    s.best = car.best;
+    if (car.clean > 0) s.average = (float)(car.sum / car.clean);
+    if (car.clean > 1) {
+        const double variance = (car.sumSquares - car.sum * car.sum / car.clean) / (car.clean - 1);
+        s.stddev = (float)std::sqrt(std::max(variance, 0.0));
+    }
+    return s;
+}
+
+} // namespace iracing
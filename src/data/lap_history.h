@@ -0,0 +1,95 @@
+#ifndef LAP_HISTORY_H
+#define LAP_HISTORY_H
+
+#include "data/car_frame.h"
+#include <cstdint>
+#include <vector>
+
+namespace iracing {
+
+// Completed laps of every car, kLaps per car in fixed ring buffers, so
+// memory does not grow with race length. A lap is detected when
+// CarIdxLapCompleted goes up; its time is CarIdxLastLapTime once that
+// changes (iRacing publishes it a moment after the line), else after
+// kOfficialWait the line-to-line time interpolated between ticks.
+//
+// Per car it keeps the best clean lap of the session and the average and
+// standard deviation of the clean laps still in the ring, all updated in
+// O(1) as laps enter and leave it. Clean means timed and not touching pit
+// road (in- and out-laps are kept in the history but flagged).
+class LapHistory {
+public:
+    static constexpr int kLaps = 32;
+    static constexpr double kOfficialWait = 2.0;  // seconds
+
+    struct Lap {
+        double sessionTime = 0.0;  // when the car crossed the line
+        float time = -1.0f;        // seconds, < 0 when untimed
+        int16_t lap = 0;           // CarIdxLapCompleted after the lap
+        bool pit = false;          // on pit road at some point of the lap
+
+        bool clean() const { return time > 0.0f && !pit; }
+    };
+
+    struct Stats {
+        int laps = 0;             // clean laps in the ring
+        float best = -1.0f;       // best clean lap of the session, < 0 = none
+        float average = -1.0f;    // of the clean laps in the ring
+        float stddev = -1.0f;     // same, < 0 with fewer than two
+    };
+
+    LapHistory();
+
+    // Forgets every lap (new session, reconnect, replay seek)
+    void reset();
+
+    // Records the laps completed since the previous frame. A time going
+    // backwards resets; a car whose lap count goes down starts over.
+    void update(const CarFrame& frame, double sessionTime);
+
+    // Laps held for car, at most kLaps
+    int count(int car) const;
+    // n-th most recent lap of car, 0 = the last one; n < count(car)
+    const Lap& recent(int car, int n) const;
+    // Copies up to maxLaps of the most recent laps, newest first
+    int recentLaps(int car, Lap* out, int maxLaps) const;
+
+    Stats stats(int car) const;
+    float bestLap(int car) const { return (car >= 0 && car < CarFrame::kMaxCars) ? m_cars[car].best : -1.0f; }
+
+private:
+    struct Car {
+        bool valid = false;
+        int lapCompleted = 0;
+        float pct = 0.0f;           // at the last update
+        double time = 0.0;
+        float lastLapTime = -1.0f;  // CarIdxLastLapTime at the last update
+        double crossing = -1.0;     // line crossing that started this lap
+        bool lapPit = false;
+
+        // Lap waiting for its official time
+        bool pending = false;
+        Lap pendingLap;
+        float lastLapBefore = -1.0f;  // CarIdxLastLapTime before the crossing
+
+        // Ring and its running sums over clean laps
+        int head = 0;   // next slot
+        int count = 0;
+        int clean = 0;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        float best = -1.0f;
+    };
+
+    void commit(int car, float time);
+    Lap* ring(int car) { return m_laps.data() + (size_t)car * kLaps; }
+    const Lap* ring(int car) const { return m_laps.data() + (size_t)car * kLaps; }
+
+    std::vector<Lap> m_laps;  // kLaps per car
+    Car m_cars[CarFrame::kMaxCars];
+    double m_now = 0.0;
+};
+
+} // namespace iracing
+
+#endif // LAP_HISTORY_H
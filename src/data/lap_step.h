@@ -0,0 +1,68 @@
+#ifndef LAP_STEP_H
+#define LAP_STEP_H
+
+namespace iracing {
+
+// A car's move along the lap between two ticks, as seen by the timers
+// that interpolate crossings from CarIdxLapDistPct (GapTimer, SectorTimer,
+// LapDelta). They all classify the move the same way and time every
+// position passed in between linearly in SessionTime.
+struct LapStep {
+    static constexpr float kMaxStep = 0.1f;   // laps per tick before it counts as a jump
+    static constexpr float kJitter = 0.001f;  // backwards noise ignored, in laps
+
+    enum Kind {
+        Still,    // not moved, or back by less than kJitter
+        Forward,  // ahead by at most kMaxStep, possibly over the line
+        Jump      // back or too far ahead: tow, reset, teleport
+    };
+
+    float laps;    // distance moved, unwrapped past the line
+    bool wrapped;  // crossed the start/finish line forwards
+    Kind kind;
+
+    LapStep(float fromPct, float toPct) {
+        laps = toPct - fromPct;
+        wrapped = laps < -0.5f;
+        if (wrapped) laps += 1.0f;
+        if (laps <= 0.0f && laps > -kJitter) kind = Still;
+        else if (laps < 0.0f || laps > kMaxStep) kind = Jump;
+        else kind = Forward;
+    }
+};
+
+// When each position of a forward step was passed. Positions are in laps
+// times scale (bins per lap for the fixed-bin timers), unwrapped past the
+// line, so a boundary b >= scale lies on the next lap.
+class LapSpan {
+public:
+    LapSpan(float fromPct, const LapStep& step, double fromTime, double toTime, double scale = 1.0)
+        : m_from((double)fromPct * scale)
+        , m_to(m_from + (double)step.laps * scale)
+        , m_time(fromTime)
+        , m_perUnit((toTime - fromTime) / (m_to - m_from))
+    {
+    }
+
+    double from() const { return m_from; }
+    double to() const { return m_to; }
+    double at(double x) const { return m_time + m_perUnit * (x - m_from); }
+
+    // Calls visit(b, at(b)) for every whole b in (from, to]; most ticks
+    // cross none or one
+    template <typename Visit>
+    void forEachBoundary(Visit visit) const {
+        const int last = (int)m_to;
+        for (int b = (int)m_from + 1; b <= last; ++b) visit(b, at((double)b));
+    }
+
+private:
+    double m_from;
+    double m_to;
+    double m_time;
+    double m_perUnit;
+};
+
+} // namespace iracing
+
+#endif // LAP_STEP_H
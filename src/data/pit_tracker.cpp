@@ -0,0 +1,126 @@
+#include "data/pit_tracker.h"
+#include "irsdk/irsdk_defines.h"
+#include <algorithm>
+#include <cmath>
+
+namespace iracing {
+
+namespace {
+
+constexpr float kStationary = 1e-6f;  // laps per tick that count as standing still
+// Lane losses outside this are tows, resets or a car parked in the pits
+constexpr float kMinLaneLoss = -30.0f;
+constexpr float kMaxLaneLoss = 120.0f;
+constexpr float kMinStop = 1.0f;      // shorter is a drive-through
+
+} // namespace
+
+PitTracker::PitTracker() {
+    reset();
+}
+
+void PitTracker::reset() {
+    for (Car& car : m_cars) car = Car();
+    m_now = 0.0;
+    m_entries = 0;
+    m_laps = 0;
+}
+
+void PitTracker::resetModel() {
+    m_laneLossSum = 0.0;
+    m_laneLossCount = 0;
+    m_stopSum = 0.0;
+    m_stopCount = 0;
+}
+
+void PitTracker::update(const CarFrame& f, double now, const LapHistory& history) {
+    if (now < m_now) reset();
+    m_now = now;
+
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        Car& car = m_cars[i];
+        if (i >= f.carCount || !f.isInWorld(i)) {
+            // A stop in progress is abandoned (towed, left the session)
+            car.valid = false;
+            car.onPitRoad = false;
+            continue;
+        }
+        const float pct = std::clamp(f.lapDistPct[i], 0.0f, 1.0f);
+        const bool onPit = f.onPitRoad[i] != 0;
+        if (!car.valid) {
+            // Appearing on pit road: the entry was not seen, so the stop
+            // is not timed
+            car.valid = true;
+            car.onPitRoad = onPit;
+            car.current = Stop();
+            car.current.entryTime = -1.0;
+            car.pct = pct;
+            car.time = now;
+            continue;
+        }
+
+        if (pct < car.pct - 0.5f) ++m_laps;
+        if (onPit && !car.onPitRoad) {
+            ++m_entries;
+            car.current = Stop();
+            car.current.entryTime = now;
+            car.current.lap = f.lapCompleted[i];
+            car.entryPct = pct;
+        } else if (onPit) {
+            const bool stationary = f.trackSurface[i] == irsdk_InPitStall || std::abs(pct - car.pct) < kStationary;
+            if (stationary) car.current.stopSeconds += (float)(now - car.time);
+        } else if (car.onPitRoad) {
+            finishStop(i, now, pct, history);
+        }
+        car.onPitRoad = onPit;
+        car.pct = pct;
+        car.time = now;
+    }
+}
+
+void PitTracker::finishStop(int i, double now, float pct, const LapHistory& history) {
+    Car& car = m_cars[i];
+    Stop& stop = car.current;
+    if (stop.entryTime < 0.0) return;
+    stop.exitTime = now;
+
+    // Pit road distance, usually across the line
+    float distance = pct - car.entryPct;
+    if (distance < 0.0f) distance += 1.0f;
+    const float pace = history.stats(i).average;
+    const float loss = (float)(stop.exitTime - stop.entryTime) - stop.stopSeconds - distance * pace;
+    stop.paced = pace > 0.0f;
+    stop.laneLoss = stop.paced ? loss : 0.0f;
+    car.last = stop;
+    ++car.stops;
+
+    if (stop.paced && loss > kMinLaneLoss && loss < kMaxLaneLoss) {
+        m_laneLossSum += loss;
+        ++m_laneLossCount;
+        if (stop.stopSeconds >= kMinStop) {
+            m_stopSum += stop.stopSeconds;
+            ++m_stopCount;
+        }
+    }
+}
+
+bool PitTracker::inPitLane(int car) const {
+    return car >= 0 && car < CarFrame::kMaxCars && m_cars[car].valid && m_cars[car].onPitRoad;
+}
+
+float PitTracker::pitRoadSeconds(int car) const {
+    if (!inPitLane(car) || m_cars[car].current.entryTime < 0.0) return 0.0f;
+    return (float)(m_now - m_cars[car].current.entryTime);
+}
+
+int PitTracker::stopCount(int car) const {
+    return (car >= 0 && car < CarFrame::kMaxCars) ? m_cars[car].stops : 0;
+}
+
+bool PitTracker::lastStop(int car, Stop& out) const {
+    if (stopCount(car) == 0) return false;
+    out = m_cars[car].last;
+    return true;
+}
+
+} // namespace iracing
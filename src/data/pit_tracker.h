@@ -0,0 +1,88 @@
+#ifndef PIT_TRACKER_H
+#define PIT_TRACKER_H
+
+#include "data/car_frame.h"
+#include "data/lap_history.h"
+#include <algorithm>
+
+namespace iracing {
+
+// Pit stops of every car from CarIdxOnPitRoad (entry and exit) and
+// CarIdxTrackSurface (time in the stall, or stationary on pit road). When
+// a car leaves pit road its stop is recorded with the pit-lane loss: the
+// time spent on pit road minus the stop and minus what the same distance
+// takes at the car's racing pace (its clean lap average).
+//
+// The losses feed a model for the track, the mean lane loss and mean stop
+// of every stop seen, so a stop can be priced before the player makes
+// one. reset() keeps the model; resetModel() is for a new track.
+class PitTracker {
+public:
+    struct Stop {
+        double entryTime = 0.0;    // SessionTime at pit road entry
+        double exitTime = 0.0;
+        float stopSeconds = 0.0f;  // stationary / in the stall
+        float laneLoss = 0.0f;     // vs racing pace, without the stop (can be < 0)
+        bool paced = false;        // laneLoss known: the car had a racing pace
+        int lap = 0;               // CarIdxLapCompleted at entry
+    };
+
+    PitTracker();
+
+    // Forgets the cars' stops and the stop chance (new session, reconnect);
+    // keeps the model
+    void reset();
+    // Forgets the model too (another track)
+    void resetModel();
+
+    // O(cars). history gives the racing pace of each car.
+    void update(const CarFrame& frame, double sessionTime, const LapHistory& history);
+
+    bool inPitLane(int car) const;
+    // Seconds since the car entered pit road, 0 off it or when the entry
+    // was not seen
+    float pitRoadSeconds(int car) const;
+    int stopCount(int car) const;
+    // The car's last completed stop; false before its first
+    bool lastStop(int car, Stop& out) const;
+
+    // Track model, false until a stop with a known pace was seen
+    bool modelReady() const { return m_laneLossCount > 0; }
+    float modelLaneLoss() const { return m_laneLossCount ? (float)(m_laneLossSum / m_laneLossCount) : 0.0f; }
+    float modelStopSeconds() const { return m_stopCount ? (float)(m_stopSum / m_stopCount) : 0.0f; }
+    // Seconds a stop costs against staying out
+    float modelPitLoss() const { return modelLaneLoss() + modelStopSeconds(); }
+    int modelSamples() const { return m_laneLossCount; }
+
+    // Odds that a car passing the pit entry takes it: pit road entries per
+    // lap started this session, 0 before the first entry
+    float stopChance() const { return m_laps > 0 ? std::min(1.0f, (float)m_entries / (float)m_laps) : 0.0f; }
+
+private:
+    struct Car {
+        bool valid = false;
+        bool onPitRoad = false;
+        float pct = 0.0f;
+        double time = 0.0;
+        Stop current;              // the stop in progress while onPitRoad
+        float entryPct = 0.0f;
+        Stop last;
+        int stops = 0;
+    };
+
+    void finishStop(int carIdx, double now, float pct, const LapHistory& history);
+
+    Car m_cars[CarFrame::kMaxCars];
+    double m_now = 0.0;
+    int m_entries = 0;
+    int m_laps = 0;  // start/finish crossings, summed over the cars
+
+    double m_laneLossSum = 0.0;
+    int m_laneLossCount = 0;
+    double m_stopSum = 0.0;
+    int m_stopCount = 0;
+};
+
+} // namespace iracing
+
+#endif // PIT_TRACKER_H
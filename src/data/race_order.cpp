@@ -0,0 +1,59 @@
+#include "data/race_order.h"
+#include <algorithm>
+#include <cmath>
+
+namespace iracing {
+
+void RaceOrder::update(const CarFrame& f) {
+    // Keep the survivors in their previous order, then append new cars
+    uint64_t members = 0;
+    int n = 0;
+    for (int k = 0; k < m_count; ++k) {
+        const int i = m_cars[k];
+        if (i < f.carCount && f.isInWorld(i)) {
+            m_cars[n++] = static_cast<uint8_t>(i);
+            members |= 1ull << i;
+        }
+    }
+    for (int i = 0; i < f.carCount; ++i) {
+        if (!((members >> i) & 1) && f.isInWorld(i)) {
+            m_cars[n++] = static_cast<uint8_t>(i);
+            members |= 1ull << i;
+        }
+    }
+    m_count = n;
+    m_members = members;
+
+    // Sort keys once per car rather than per comparison
+    float dist[CarFrame::kMaxCars];
+    int pos[CarFrame::kMaxCars];
+    for (int k = 0; k < n; ++k) {
+        const int i = m_cars[k];
+        dist[i] = std::min(1.0f, std::max(0.0f, f.lapDistPct[i]));
+        pos[i] = (f.position[i] > 0) ? f.position[i] : 9999;
+    }
+
+    auto ahead = [&](int a, int b) {
+        const int dl = f.lapCompleted[a] - f.lapCompleted[b];
+        const float dd = dist[a] - dist[b];
+        const bool byDist = std::abs(dd) > 0.001f ? dd > 0.0f : pos[a] < pos[b];
+        return dl != 0 ? dl > 0 : byDist;
+    };
+
+    // Stable insertion sort; the comparator's distance tolerance is not a
+    // strict weak ordering, which std::sort does not tolerate
+    int moves = 0;
+    for (int k = 1; k < n; ++k) {
+        const uint8_t carIdx = m_cars[k];
+        int j = k;
+        while (j > 0 && ahead(carIdx, m_cars[j - 1])) {
+            m_cars[j] = m_cars[j - 1];
+            --j;
+        }
+        moves += k - j;
+        m_cars[j] = carIdx;
+    }
+    m_lastMoves = moves;
+}
+
+} // namespace iracing
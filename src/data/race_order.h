@@ -0,0 +1,40 @@
+#ifndef RACE_ORDER_H
+#define RACE_ORDER_H
+
+#include "data/car_frame.h"
+#include <cstdint>
+
+namespace iracing {
+
+// Race order of the cars in a CarFrame as CarIdx bytes, leader first.
+// Kept from tick to tick: update() drops cars that left the world, appends
+// new ones and re-sorts the previous order, which is almost always sorted
+// already, so the insertion sort only moves the few cars that overtook
+// (or crossed the line) since the last frame.
+class RaceOrder {
+public:
+    // Forgets the previous order; the next update() sorts from CarIdx order
+    void reset() { m_count = 0; m_members = 0; }
+
+    void update(const CarFrame& frame);
+
+    const uint8_t* cars() const { return m_cars; }
+    int count() const { return m_count; }
+    uint64_t members() const { return m_members; }  // bit per CarIdx
+    bool contains(int carIdx) const {
+        return carIdx >= 0 && carIdx < CarFrame::kMaxCars && (m_members >> carIdx) & 1;
+    }
+
+    // Index moves done by the last update() (0 when nothing changed places)
+    int lastMoves() const { return m_lastMoves; }
+
+private:
+    uint8_t m_cars[CarFrame::kMaxCars] = {};
+    int m_count = 0;
+    uint64_t m_members = 0;  // bit per CarIdx in m_cars
+    int m_lastMoves = 0;
+};
+
+} // namespace iracing
+
+#endif // RACE_ORDER_H
@@ -3,13 +3,19 @@
 #include "data/irating_calc.h"
 #include "utils/yaml_parser.h"
 #include <algorithm>
-#include <map>
-#include <sstream>
 #include <cmath>
-#include <iostream>
+#include <cstdio>
 
 namespace iracing {
 
+namespace {
+
+float clampLapDist(float pct) {
+    return std::min(1.0f, std::max(0.0f, pct));
+}
+
+} // namespace
+
 RelativeCalculator::RelativeCalculator(IRSDKManager* sdk)
     : m_sdk(sdk)
     , m_playerCarIdx(-1)
@@ -23,257 +29,480 @@ RelativeCalculator::RelativeCalculator(IRSDKManager* sdk)
     , m_playerLastLap(-1.0f)
     , m_playerBestLap(-1.0f)
     , m_lastSessionInfoUpdate(-1)
+    , m_session(SessionTable::build({}, -1))
+    , m_sessionWorker(std::make_unique<SessionInfoWorker>())
 {
+    bindDrivers();
 }
 
 void RelativeCalculator::update() {
     if (!m_sdk || !m_sdk->isSessionActive()) {
-        m_allDrivers.clear();
+        if (m_order.count() > 0) ++m_resultsVersion;
+        m_order.reset();
+        m_invalidated = true;
         return;
     }
 
+    // Session info changes are handed to the worker; its parsed table is
+    // adopted here once published, without waiting for it
     int currentUpdate = m_sdk->getSessionInfoUpdate();
-    if (currentUpdate != m_lastSessionInfoUpdate) {
-        updateSessionInfo();
+    if (currentUpdate != m_lastSessionInfoUpdate && updateSessionInfo()) {
         m_lastSessionInfoUpdate = currentUpdate;
     }
+    if (m_sessionWorker) {
+        auto table = m_sessionWorker->latest();
+        if (table != m_session && table->sessionInfoUpdate >= 0) setSessionTable(std::move(table));
+    }
 
-    m_allDrivers.clear();
-    m_allDrivers.reserve(64);
+    // Results only depend on the manager's row (and the session table);
+    // without a new one (render rate above tick rate, paused replay) the
+    // previous results still hold
+    const uint64_t version = m_sdk->getDataVersion();
+    if (version == m_dataVersion && !m_invalidated) {
+        ++m_updatesSkipped;
+        return;
+    }
+    m_dataVersion = version;
+    m_invalidated = false;
+    ++m_updatesComputed;
+    ++m_resultsVersion;
+
+    const bool reconnected = m_sdk->getHeaderGeneration() != m_varGeneration;
+    if (reconnected) {
+        resolveVarHandles();
+        m_order.reset();
+        m_gapTimer.reset();
+        m_lapHistory.reset();
+        m_sectorTimer.reset();
+        m_lapDelta.reset();
+        m_pitTracker.reset();
+    }
 
-    m_playerCarIdx = m_sdk->getInt("PlayerCarIdx", -1);
-    m_lapsComplete = m_sdk->getInt("Lap", 0);
-    m_sessionTime = m_sdk->getFloat("SessionTime", 0.0f);
-    m_sessionTimeRemain = m_sdk->getFloat("SessionTimeRemain", 0.0f);
+    m_playerCarIdx = m_sdk->getInt(m_varPlayerCarIdx, -1);
+    m_lapsComplete = m_sdk->getInt(m_varLap, 0);
+    const double sessionTime = m_sdk->getDouble(m_varSessionTime, 0.0);
+    m_sessionTime = static_cast<float>(sessionTime);
+    m_sessionTimeRemain = m_sdk->getFloat(m_varSessionTimeRemain, 0.0f);
 
     // Player stats
-    m_playerIncidents = m_sdk->getInt("PlayerCarMyIncidentCount", 0);
-    float curLast = m_sdk->getFloat("LapLastLapTime", -1.0f);
+    m_playerIncidents = m_sdk->getInt(m_varIncidents, 0);
+    float curLast = m_sdk->getFloat(m_varLapLastLapTime, -1.0f);
     if (curLast > 0.0f) m_playerLastLap = curLast;
-    float curBest = m_sdk->getFloat("LapBestLapTime", -1.0f);
+    float curBest = m_sdk->getFloat(m_varLapBestLapTime, -1.0f);
     if (curBest > 0.0f) m_playerBestLap = curBest;
 
-    int lapCount = 0;
-    const int* carLap = m_sdk->getIntArray("CarIdxLap", lapCount);
-    const int* carLapCompleted = m_sdk->getIntArray("CarIdxLapCompleted", lapCount);
-    int posCount = 0;
-    const int* positions = m_sdk->getIntArray("CarIdxPosition", posCount);
-    int distCount = 0;
-    const float* lapDistPct = m_sdk->getFloatArray("CarIdxLapDistPct", distCount);
-    int f2Count = 0;
-    const float* f2Times = m_sdk->getFloatArray("CarIdxF2Time", f2Count);
-    int lapTimeCount = 0;
-    const float* lastLapTime = m_sdk->getFloatArray("CarIdxLastLapTime", lapTimeCount);
-    int pitCount = 0;
-    const int* onPitRoad = m_sdk->getIntArray("CarIdxOnPitRoad", pitCount);
-    int surfaceCount = 0;
-    const int* trackSurface = m_sdk->getIntArray("CarIdxTrackSurface", surfaceCount);
-
-    if (!lapDistPct) return;
-
-    std::vector<int> allIRatings;
-    allIRatings.reserve(64);
-
-    int maxIdx = posCount;
-    if (distCount > 0 && distCount < maxIdx) maxIdx = distCount;
-    if (maxIdx > 64) maxIdx = 64;
-
-    for (int i = 0; i < maxIdx; ++i) {
-        if (trackSurface && i < surfaceCount && trackSurface[i] < 0) continue;
-        if (i < distCount && lapDistPct[i] < -0.5f) continue;
-        if (positions && i < posCount && positions[i] < 0) continue;
-
-        Driver driver;
-        driver.carIdx = i;
-        driver.position = (positions && i < posCount) ? positions[i] : 0;
-        driver.lapDistPct = (i < distCount) ? lapDistPct[i] : 0.0f;
-        if (driver.lapDistPct < 0.0f) driver.lapDistPct = 0.0f;
-        if (driver.lapDistPct > 1.0f) driver.lapDistPct = 1.0f;
-        driver.isOnPit = (onPitRoad && i < pitCount && onPitRoad[i] != 0);
-        driver.isPlayer = (i == m_playerCarIdx);
-        driver.lap = (carLap && i < lapCount) ? carLap[i] : 0;
-        driver.lapCompleted = (carLapCompleted && i < lapCount) ? carLapCompleted[i] : 0;
-        driver.lastLapTime = (lastLapTime && i < lapTimeCount) ? lastLapTime[i] : 0.0f;
-        if (driver.lastLapTime <= 0.0f) driver.lastLapTime = -1.0f;
-
-        auto it = m_driverInfoMap.find(i);
-        if (it != m_driverInfoMap.end()) {
-            const auto& di = it->second;
-            driver.carNumber = di.carNumber.empty() ? std::to_string(i + 1) : di.carNumber;
-            driver.driverName = di.userName.empty() ? "Unknown" : di.userName;
-            driver.iRating = di.iRating;
-            driver.countryCode = di.countryCode;
-
-            if (di.licSubLevel > 0) {
-                driver.safetyRating = static_cast<float>(di.licSubLevel) / 100.0f;
-            } else if (!di.licString.empty()) {
-                driver.safetyRating = parseSafetyRatingFromLicString(di.licString);
-            } else {
-                if (di.licenseLevel >= 1 && di.licenseLevel <= 20) {
-                    int cb = ((di.licenseLevel - 1) / 4);
-                    int sl = ((di.licenseLevel - 1) % 4);
-                    driver.safetyRating = (float)cb + sl * 0.25f;
-                } else {
-                    driver.safetyRating = 2.5f;
-                }
-            }
-            driver.carBrand = getCarBrand(di.carPath);
-            driver.carClass = di.carClassShortName.empty() ? "???" : di.carClassShortName;
-        } else {
-            driver.carNumber = std::to_string(i + 1);
-            driver.driverName = "Driver " + std::to_string(i);
-            driver.iRating = 1500;
-            driver.safetyRating = 2.5f;
-            driver.carBrand = "unknown";
-            driver.carClass = "Unknown";
+    // The frame only changes with the row, copy it once per new tick
+    if (reconnected || m_frame.tickCount != m_sdk->getSnapshot().tickCount()) {
+        if (!m_frameReader.read(*m_sdk, m_frame)) { m_order.reset(); return; }
+        m_gapTimer.update(m_frame, sessionTime);
+        m_lapHistory.update(m_frame, sessionTime);
+        m_sectorTimer.update(m_frame, sessionTime);
+        if (m_session.get() != m_lapDeltaSession || m_playerCarIdx != m_lapDeltaPlayer) bindLapDelta();
+        m_lapDelta.update(m_frame, m_playerCarIdx, sessionTime);
+        m_pitTracker.update(m_frame, sessionTime, m_lapHistory);
+    }
+    if (m_frame.tickCount < 0) { m_order.reset(); return; }
+
+    // Ordering, SOF and gaps run over the frame; only the per-tick fields
+    // of the cars that made it into the order are rewritten
+    buildOrder();
+    calculateClasses();
+    calculateGaps();
+
+    for (int i = 0; i < m_order.count(); ++i) {
+        updateDriver(m_order.cars()[i], i + 1);
+    }
+    calculateTrackGaps();
+    calculatePitRejoin();
+
+    calculateiRatingProjections();
+}
+
+void RelativeCalculator::buildOrder() {
+    m_order.update(m_frame);
+    m_playerInOrder = m_order.contains(m_playerCarIdx);
+}
+
+void RelativeCalculator::updateDriver(int i, int relativePosition) {
+    const CarFrame& f = m_frame;
+
+    Driver& driver = m_drivers[i];
+    driver.relativePosition = relativePosition;
+    driver.position = f.position[i];
+    driver.lapDistPct = clampLapDist(f.lapDistPct[i]);
+    driver.isOnPit = f.onPitRoad[i] != 0;
+    driver.isPlayer = (i == m_playerCarIdx);
+    driver.lap = f.lap[i];
+    driver.lapCompleted = f.lapCompleted[i];
+    driver.lastLapTime = f.lastLapTime[i];
+    if (driver.lastLapTime <= 0.0f) driver.lastLapTime = -1.0f;
+    driver.bestLapTime = m_lapHistory.bestLap(i);
+    driver.pitStops = m_pitTracker.stopCount(i);
+    driver.gapToLeader = m_gapToLeader[i];
+    driver.gapToPlayer = m_gapToPlayer[i];
+    driver.gapToClassLeader = m_gapToClassLeader[i];
+}
+
+void RelativeCalculator::calculateClasses() {
+    // One pass in race order: a class's first car is its leader and each
+    // car's class position is its class's running count
+    uint64_t members[kMaxClasses] = {};
+    int size[kMaxClasses] = {};
+    const uint8_t* order = m_order.cars();
+    for (int n = 0; n < m_order.count(); ++n) {
+        const int i = order[n];
+        Driver& d = m_drivers[i];
+        const int c = d.classIndex;
+        if (c == Driver::kNoClass) {
+            d.classPosition = 0;
+            continue;
         }
+        if (size[c] == 0) m_classLeader[c] = i;
+        members[c] |= 1ull << i;
+        d.classPosition = ++size[c];
+    }
 
-        allIRatings.push_back(driver.iRating);
-        m_allDrivers.push_back(std::move(driver));
+    // SOF and expected scores only change with a field's members (cars
+    // joining or leaving the world) or a new session table
+    const uint64_t racing = m_order.members() & ~m_paceCars;
+    if (m_fieldsStale || racing != m_sofMembers) {
+        m_sofMembers = racing;
+        int ratings[CarFrame::kMaxCars];
+        int count = 0;
+        for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+            if ((m_sofMembers >> i) & 1) ratings[count++] = m_session->iRating[i];
+        }
+        if (count > 0) m_sof = iRatingCalculator::calculateSOF(ratings, count);
     }
+    for (int c = 0; c < m_classCount; ++c) {
+        m_classSize[c] = size[c];
+        if (size[c] == 0) m_classLeader[c] = -1;
+        if (m_fieldsStale || members[c] != m_classMembers[c]) {
+            m_classMembers[c] = members[c];
+            bindField(c);
+        }
+        m_classSof[c] = m_classField[c].sof();
+    }
+    m_fieldsStale = false;
+}
 
-    if (!allIRatings.empty()) m_sof = iRatingCalculator::calculateSOF(allIRatings);
+void RelativeCalculator::bindField(int classIndex) {
+    // Slots in CarIdx order
+    int ratings[CarFrame::kMaxCars];
+    int count = 0;
+    const uint64_t members = m_classMembers[classIndex];
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        if (!((members >> i) & 1)) continue;
+        m_fieldSlot[i] = static_cast<uint8_t>(count);
+        ratings[count++] = m_session->iRating[i];
+    }
+    m_classField[classIndex].setField(ratings, count);
+}
 
-    std::stable_sort(m_allDrivers.begin(), m_allDrivers.end(),
-        [](const Driver& a, const Driver& b) {
-            if (a.lapCompleted != b.lapCompleted) return a.lapCompleted > b.lapCompleted;
-            if (std::abs(a.lapDistPct - b.lapDistPct) > 0.001f) return a.lapDistPct > b.lapDistPct;
-            int pa = (a.position > 0) ? a.position : 9999;
-            int pb = (b.position > 0) ? b.position : 9999;
-            return pa < pb;
-        });
+void RelativeCalculator::resolveVarHandles() {
+    m_varPlayerCarIdx = m_sdk->getVarHandle("PlayerCarIdx");
+    m_varLap = m_sdk->getVarHandle("Lap");
+    m_varSessionTime = m_sdk->getVarHandle("SessionTime");
+    m_varSessionTimeRemain = m_sdk->getVarHandle("SessionTimeRemain");
+    m_varIncidents = m_sdk->getVarHandle("PlayerCarMyIncidentCount");
+    m_varLapLastLapTime = m_sdk->getVarHandle("LapLastLapTime");
+    m_varLapBestLapTime = m_sdk->getVarHandle("LapBestLapTime");
+    m_varGeneration = m_sdk->getHeaderGeneration();
+}
 
-    for (size_t i = 0; i < m_allDrivers.size(); ++i)
-        m_allDrivers[i].relativePosition = (int)(i + 1);
+void RelativeCalculator::setSessionInfoAsync(bool async) {
+    if (async == (m_sessionWorker != nullptr)) return;
+    m_sessionWorker = async ? std::make_unique<SessionInfoWorker>() : nullptr;
+    m_lastSessionInfoUpdate = -1;  // resubmit the current string
+}
 
-    calculateGaps(f2Times, f2Count);
-    calculateiRatingProjections();
+bool RelativeCalculator::updateSessionInfo() {
+    int update = 0;
+    if (!m_sdk->copySessionInfo(m_sessionYaml, update)) return false;
+
+    if (m_sessionWorker) {
+        m_sessionWorker->submit(m_sessionYaml, update);
+    } else {
+        setSessionTable(SessionTable::build(m_sessionYaml, update, m_session.get()));
+    }
+    return true;
+}
+
+void RelativeCalculator::setSessionTable(std::shared_ptr<const SessionTable> table) {
+    m_changedDrivers |= table->changedDrivers(*m_session);
+    if (table->trackName != m_session->trackName) m_pitTracker.resetModel();  // the model is per track
+    m_session = std::move(table);
+    m_sectorTimer.setSectors(m_session->sectorStarts.data(), (int)m_session->sectorStarts.size());
+
+    m_seriesName = m_session->seriesName;
+    m_totalLaps = m_session->sessionLaps;
+    bindDrivers();
+    m_invalidated = true;
+}
+
+void RelativeCalculator::bindDrivers() {
+    // The table has the session fields bound already; per-tick fields are
+    // rewritten for the cars in the order
+    m_classCount = m_session->classCount;
+    m_paceCars = m_session->paceCars;
+    m_fieldsStale = true;
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        const SessionTable::Car& bound = m_session->cars[i];
+        Driver& car = m_drivers[i];
+        car = Driver();
+        car.carIdx = i;
+        car.carNumber = bound.carNumber;
+        car.driverName = bound.driverName;
+        car.carClass = bound.carClass;
+        car.carBrand = bound.carBrand;
+        car.countryCode = bound.countryCode;
+        car.iRating = bound.iRating;
+        car.safetyRating = bound.safetyRating;
+        car.classIndex = bound.classIndex;
+    }
+}
+
+void RelativeCalculator::calculateGaps() {
+    std::fill(m_gapToLeader, m_gapToLeader + CarFrame::kMaxCars, 0.0f);
+    std::fill(m_gapToClassLeader, m_gapToClassLeader + CarFrame::kMaxCars, 0.0f);
+    std::fill(m_gapToPlayer, m_gapToPlayer + CarFrame::kMaxCars, 0.0f);
+    m_timedToPlayer = 0;
+    if (m_order.count() == 0) return;
+
+    const uint8_t* order = m_order.cars();
+    const int leader = order[0];
+    const int player = m_playerInOrder ? m_playerCarIdx : -1;
+
+    bool timed = false;
+    for (int n = 0; n < m_order.count(); ++n) {
+        const int i = order[n];
+        m_gapToLeader[i] = timeGap(i, leader, timed);
+        const int c = m_drivers[i].classIndex;
+        if (c != Driver::kNoClass) m_gapToClassLeader[i] = timeGap(i, m_classLeader[c], timed);
+        if (player >= 0) {
+            m_gapToPlayer[i] = timeGap(i, player, timed);
+            if (timed) m_timedToPlayer |= 1ull << i;
+        }
+    }
 }
 
-void RelativeCalculator::updateSessionInfo() {
-    const char* yaml = m_sdk->getSessionInfo();
-    if (!yaml) return;
-    auto info = utils::YAMLParser::parse(yaml);
-    m_seriesName = info.seriesName;
-    m_totalLaps = info.sessionLaps;
-    m_driverInfoMap.clear();
-    for (const auto& di : info.drivers) {
-        if (di.carIdx >= 0) m_driverInfoMap[di.carIdx] = di;
+float RelativeCalculator::timeGap(int i, int ref, bool& timed) const {
+    // Positive when i is behind ref. F2Time when both cars have one, else
+    // the gap timer, else laps and lap fraction until the timer has seen
+    // the crossing it needs; timed is false for that last one
+    timed = true;
+    if (i == ref) return 0.0f;
+    const CarFrame& f = m_frame;
+    if (f.f2Time[i] > 0.01f && f.f2Time[ref] > 0.01f) return f.f2Time[i] - f.f2Time[ref];
+
+    float seconds = 0.0f;
+    if (m_gapTimer.gap(i, ref, seconds)) return seconds;
+
+    timed = false;
+    const int ld = f.lapCompleted[ref] - f.lapCompleted[i];
+    const float dd = clampLapDist(f.lapDistPct[ref]) - clampLapDist(f.lapDistPct[i]);
+    return (float)ld + dd;
+}
+
+void RelativeCalculator::calculateTrackGaps() {
+    const CarFrame& f = m_frame;
+    const uint8_t* order = m_order.cars();
+    const int count = m_order.count();
+    if (!m_playerInOrder) {
+        for (int n = 0; n < count; ++n) {
+            m_trackDistance[order[n]] = 0.0f;
+            m_drivers[order[n]].trackDistance = 0.0f;
+            m_drivers[order[n]].trackGap = 0.0f;
+            m_drivers[order[n]].trackGapValid = false;
+        }
+        return;
+    }
+
+    // Seconds per lap for the conversion: the player's best lap, else the
+    // class estimate from the session info, else the player's last lap as
+    // reported or as timed at the line. Without any there is no gap.
+    float lapTime = m_playerBestLap > 0.0f ? m_playerBestLap : m_session->cars[m_playerCarIdx].estLapTime;
+    if (lapTime <= 0.0f) lapTime = f.lastLapTime[m_playerCarIdx];
+    if (lapTime <= 0.0f) lapTime = m_gapTimer.lapTime(m_playerCarIdx);
+    const bool timed = lapTime > 0.0f;
+
+    const float playerPct = clampLapDist(f.lapDistPct[m_playerCarIdx]);
+    for (int n = 0; n < count; ++n) {
+        const int i = order[n];
+        float d = clampLapDist(f.lapDistPct[i]) - playerPct;
+        if (d > 0.5f) d -= 1.0f;
+        else if (d <= -0.5f) d += 1.0f;
+        m_trackDistance[i] = d;
+        m_drivers[i].trackDistance = d;
+        m_drivers[i].trackGap = timed ? -d * lapTime : 0.0f;
+        m_drivers[i].trackGapValid = timed;
     }
 }
 
-void RelativeCalculator::calculateGaps(const float* f2Times, int f2Count) {
-    if (m_allDrivers.empty()) return;
-    Driver* leader = nullptr;
-    Driver* player = nullptr;
-    for (auto& d : m_allDrivers) {
-        if (d.relativePosition == 1) leader = &d;
-        if (d.isPlayer) player = &d;
+DriverView RelativeCalculator::selectTrackRelative(int ahead, int behind) const {
+    const uint8_t* order = m_order.cars();
+    const int count = m_order.count();
+    int nf = 0, nb = 0;
+    for (int n = 0; n < count; ++n) {
+        const int i = order[n];
+        if (i != m_playerCarIdx) (m_trackDistance[i] > 0.0f ? nf : nb)++;
     }
-    if (!leader) return;
-
-    for (auto& d : m_allDrivers) {
-        float gl = 0.0f, gp = 0.0f;
-        bool vf = (f2Times && d.carIdx < f2Count && leader->carIdx < f2Count &&
-                   f2Times[d.carIdx] > 0.01f && f2Times[leader->carIdx] > 0.01f);
-        if (vf) {
-            gl = f2Times[d.carIdx] - f2Times[leader->carIdx];
+
+    // A short side lends its rows to the other, as in race order
+    ahead = std::max(0, ahead);
+    behind = std::max(0, behind);
+    if (nf < ahead) behind += ahead - nf;
+    if (nb < behind) ahead += behind - nb;
+    ahead = std::min(ahead, nf);
+    behind = std::min(behind, nb);
+
+    // Partial selection in one pass: each side keeps its nearest cars
+    // sorted nearest first, and a car farther than the side's last kept
+    // one costs a single comparison
+    uint8_t front[CarFrame::kMaxCars], back[CarFrame::kMaxCars];
+    float frontDist[CarFrame::kMaxCars], backDist[CarFrame::kMaxCars];
+    int kf = 0, kb = 0;
+    auto keep = [](uint8_t* cars, float* dist, int& kept, int limit, uint8_t carIdx, float d) {
+        if (kept == limit && !(d < dist[kept - 1])) return;
+        int j = kept < limit ? kept++ : kept - 1;
+        for (; j > 0 && d < dist[j - 1]; --j) {
+            cars[j] = cars[j - 1];
+            dist[j] = dist[j - 1];
+        }
+        cars[j] = carIdx;
+        dist[j] = d;
+    };
+    for (int n = 0; n < count; ++n) {
+        const int i = order[n];
+        if (i == m_playerCarIdx) continue;
+        const float d = m_trackDistance[i];
+        if (d > 0.0f) {
+            if (ahead > 0) keep(front, frontDist, kf, ahead, static_cast<uint8_t>(i), d);
+        } else if (behind > 0) {
+            keep(back, backDist, kb, behind, static_cast<uint8_t>(i), -d);
+        }
+    }
+
+    // Rows run from the farthest car ahead down to the farthest behind
+    uint8_t* rows = m_trackRows;
+    int n = 0;
+    for (int k = kf - 1; k >= 0; --k) rows[n++] = front[k];
+    rows[n++] = static_cast<uint8_t>(m_playerCarIdx);
+    for (int k = 0; k < kb; ++k) rows[n++] = back[k];
+    return DriverView(m_drivers, rows, n);
+}
+
+void RelativeCalculator::calculatePitRejoin() {
+    // The player keeps their track position and loses pitLoss seconds.
+    // Every timed car is weighed by the odds of it taking the pit entry
+    // it reaches next: if it stays out it ends behind by gap - pitLoss, if
+    // it pits too it keeps its gap. A car already on pit road has its gap
+    // grown by the loss so far and ends behind by gap - pitLoss plus what
+    // is left of its own. Cars without a gap in seconds are left out
+    m_pitRejoin = PitRejoin();
+    if (!m_playerInOrder || !m_pitTracker.modelReady() || m_pitTracker.inPitLane(m_playerCarIdx)) return;
+
+    const float loss = m_pitTracker.modelPitLoss();
+    const float pits = m_pitTracker.stopChance();
+    float ahead = 0.0f;
+    float closestAhead = -1e9f, closestBehind = 1e9f;
+    const uint8_t* order = m_order.cars();
+    for (int n = 0; n < m_order.count(); ++n) {
+        const int i = order[n];
+        if (i == m_playerCarIdx || !(m_timedToPlayer & (1ull << i))) continue;
+        const float gap = m_gapToPlayer[i];
+        float behind = gap - loss;  // after the stop, staying out
+        if (m_pitTracker.inPitLane(i)) {
+            behind += std::max(0.0f, loss - m_pitTracker.pitRoadSeconds(i));
+            if (behind < 0.0f) ahead += 1.0f;
         } else {
-            int ld = leader->lapCompleted - d.lapCompleted;
-            float dd = leader->lapDistPct - d.lapDistPct;
-            gl = (float)ld + dd;
+            if (behind < 0.0f) ahead += 1.0f - pits;
+            if (gap < 0.0f) ahead += pits;
         }
-        d.gapToLeader = gl;
-
-        if (player) {
-            bool vpf = (f2Times && player->carIdx < f2Count && f2Times[player->carIdx] > 0.01f);
-            if (vf && vpf) {
-                gp = f2Times[d.carIdx] - f2Times[player->carIdx];
-            } else {
-                int ld = d.lapCompleted - player->lapCompleted;
-                float dd = d.lapDistPct - player->lapDistPct;
-                gp = (float)ld + dd;
-            }
-            d.gapToPlayer = gp;
+        if (behind < 0.0f) {
+            if (behind > closestAhead) { closestAhead = behind; m_pitRejoin.carAhead = i; }
+        } else if (behind < closestBehind) {
+            closestBehind = behind;
+            m_pitRejoin.carBehind = i;
         }
     }
+    m_pitRejoin.valid = true;
+    m_pitRejoin.pitLoss = loss;
+    m_pitRejoin.position = 1 + (int)std::lround(ahead);
+    if (m_pitRejoin.carAhead >= 0) m_pitRejoin.gapAhead = -closestAhead;
+    if (m_pitRejoin.carBehind >= 0) m_pitRejoin.gapBehind = closestBehind;
+}
+
+void RelativeCalculator::setReferenceLapDir(const std::string& dir) {
+    m_referenceLapDir = dir;
+    m_lapDeltaFile.clear();
+    m_lapDeltaSession = nullptr;  // reopened on the next frame
+}
+
+void RelativeCalculator::bindLapDelta() {
+    m_lapDeltaSession = m_session.get();
+    m_lapDeltaPlayer = m_playerCarIdx;
+    const auto* player = m_session->driver(m_playerCarIdx);
+    if (!player || player->carPath.empty() || m_session->trackName.empty()) return;
+
+    std::string file = LapDelta::fileName(m_session->trackName, player->carPath);
+    if (file == m_lapDeltaFile) return;
+    m_lapDeltaFile = std::move(file);
+    m_lapDelta.open(m_referenceLapDir.empty() ? std::string() : m_referenceLapDir + "/" + m_lapDeltaFile);
 }
 
 void RelativeCalculator::calculateiRatingProjections() {
-    if (m_allDrivers.empty()) return;
-    int total = (int)m_allDrivers.size();
-    for (auto& d : m_allDrivers) {
-        d.iRatingProjection = iRatingCalculator::calculateDelta(d.iRating, m_sof, d.relativePosition, total);
+    // Each class is its own race for iRating
+    for (int n = 0; n < m_order.count(); ++n) {
+        Driver& d = m_drivers[m_order.cars()[n]];
+        const int c = d.classIndex;
+        d.iRatingProjection = c == Driver::kNoClass ? 0 : m_classField[c].delta(m_fieldSlot[d.carIdx], d.classPosition);
     }
 }
 
-std::vector<Driver> RelativeCalculator::getRelative(int ahead, int behind) const {
-    std::vector<Driver> rel;
-    if (m_allDrivers.empty()) return rel;
-    int playerPos = -1;
-    for (auto& d : m_allDrivers) { if (d.isPlayer) { playerPos = d.relativePosition; break; } }
+DriverView RelativeCalculator::getRelative(int ahead, int behind) const {
+    // Relative positions are order slots + 1, so the window is one
+    // contiguous run of the order
+    const int total = m_order.count();
+    if (total == 0) return DriverView();
+    if (m_mode == RelativeMode::Track && m_playerInOrder) return selectTrackRelative(ahead, behind);
+    const int playerPos = m_playerInOrder ? m_drivers[m_playerCarIdx].relativePosition : -1;
     if (playerPos < 1) {
-        int c = std::min((int)m_allDrivers.size(), ahead + behind + 1);
-        for (int i = 0; i < c; i++) rel.push_back(m_allDrivers[i]);
-        return rel;
+        return DriverView(m_drivers, m_order.cars(), std::min(total, ahead + behind + 1));
     }
-    int total = (int)m_allDrivers.size();
     int sa = behind, sb = ahead;
     int sp = std::max(1, playerPos - sa);
     int ep = std::min(total, playerPos + sb);
     if (sp == 1 && ep < total) ep = std::min(total, 1 + sa + sb);
     if (ep == total && sp > 1) sp = std::max(1, total - sa - sb);
-    for (auto& d : m_allDrivers) {
-        if (d.relativePosition >= sp && d.relativePosition <= ep) rel.push_back(d);
-    }
-    return rel;
+    return DriverView(m_drivers, m_order.cars() + sp - 1, ep - sp + 1);
 }
 
-std::string RelativeCalculator::getSeriesName() const { return m_seriesName; }
-
 std::string RelativeCalculator::getLapInfo() const {
-    std::ostringstream oss;
+    char buf[32];
     if (m_totalLaps > 0 && m_totalLaps < 999) {
-        oss << m_lapsComplete << "/" << m_totalLaps;
+        snprintf(buf, sizeof(buf), "%d/%d", m_lapsComplete, m_totalLaps);
     } else {
         int min = (int)(m_sessionTimeRemain / 60.0f);
         int sec = (int)m_sessionTimeRemain % 60;
-        oss << min << ":" << (sec < 10 ? "0" : "") << sec << " remain";
+        snprintf(buf, sizeof(buf), "%d:%02d remain", min, sec);
     }
-    return oss.str();
+    return buf;
 }
 
 int RelativeCalculator::getSOF() const { return m_sof; }
 
-float RelativeCalculator::parseSafetyRatingFromLicString(const std::string& ls) {
-    if (ls.empty()) return 2.5f;
-    float base = 2.0f;
-    switch (ls[0]) {
-        case 'R': base = 0.0f; break; case 'D': base = 1.0f; break;
-        case 'C': base = 2.0f; break; case 'B': base = 3.0f; break;
-        case 'A': base = 4.0f; break;
-    }
-    size_t ns = ls.find_first_of("0123456789.");
-    if (ns != std::string::npos) {
-        try {
-            float n = std::stof(ls.substr(ns));
-            return base + (n - (float)(int)n);
-        } catch (...) {}
-    }
-    return base + 0.5f;
+int RelativeCalculator::getClassSize(int classIndex) const {
+    return (classIndex >= 0 && classIndex < m_classCount) ? m_classSize[classIndex] : 0;
 }
 
-std::string RelativeCalculator::getCarBrand(const std::string& carPath) {
-    static const std::map<std::string, std::string> brands = {
-        {"bmw","bmw"},{"mercedes","mercedes"},{"audi","audi"},{"porsche","porsche"},
-        {"ferrari","ferrari"},{"lamborghini","lamborghini"},{"aston","aston_martin"},
-        {"mclaren","mclaren"},{"ford","ford"},{"chevrolet","chevrolet"},
-        {"toyota","toyota"},{"mazda","mazda"}
-    };
-    std::string lower = carPath;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    for (auto& [k, v] : brands) { if (lower.find(k) != std::string::npos) return v; }
-    return "unknown";
+int RelativeCalculator::getClassSOF(int classIndex) const {
+    return (classIndex >= 0 && classIndex < m_classCount) ? m_classSof[classIndex] : 0;
+}
+
+int RelativeCalculator::getPlayerClassSOF() const {
+    const int c = m_playerInOrder ? m_drivers[m_playerCarIdx].classIndex : Driver::kNoClass;
+    return c != Driver::kNoClass ? m_classSof[c] : m_sof;
 }
 
 } // namespace iracing
@@ -1,10 +1,22 @@
 #ifndef RELATIVE_CALC_H
 #define RELATIVE_CALC_H
 
+#include "data/car_frame.h"
+#include "data/gap_timer.h"
+#include "data/irating_calc.h"
+#include "data/lap_delta.h"
+#include "data/lap_history.h"
+#include "data/pit_tracker.h"
+#include "data/irsdk_manager.h"
+#include "data/race_order.h"
+#include "data/sector_timer.h"
+#include "data/session_info_worker.h"
+#include "utils/string_pool.h"
 #include "utils/yaml_parser.h"
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 
 namespace iracing {
 
@@ -16,51 +28,182 @@ struct Driver {
     int lapCompleted = 0;
     float lapDistPct = 0.0f;
     float lastLapTime = 0.0f;
+    float bestLapTime = -1.0f;  // best clean lap (see LapHistory), < 0 = none
     float gapToLeader = 0.0f;
     float gapToPlayer = 0.0f;
+    // Class (see RelativeCalculator::getClassCount()), position in it by
+    // race order and gap to its leader. The pace car has kNoClass and none
+    // of the three
+    static constexpr int kNoClass = SessionTable::kNoClass;
+    int classIndex = 0;
+    int classPosition = 0;
+    float gapToClassLeader = 0.0f;
+    // Around the lap from the player, wrapped into (-0.5, 0.5] laps with
+    // cars ahead positive, and the same as seconds (ahead negative, like
+    // the F2Time gaps). trackGapValid is false while no lap time is known
+    // to convert with
+    float trackDistance = 0.0f;
+    float trackGap = 0.0f;
+    bool trackGapValid = false;
     bool isOnPit = false;
+    int pitStops = 0;  // completed stops seen this session
     bool isPlayer = false;
-    std::string carNumber;
-    std::string driverName;
-    std::string carClass;
-    std::string carBrand;
-    std::string countryCode;
+    // Handles into RelativeCalculator::strings(), valid until its next
+    // session info change (which also changes the results version)
+    utils::StringId carNumber = utils::kEmptyString;
+    utils::StringId driverName = utils::kEmptyString;
+    utils::StringId carClass = utils::kEmptyString;
+    utils::StringId carBrand = utils::kEmptyString;
+    utils::StringId countryCode = utils::kEmptyString;
     int iRating = 1500;
     float safetyRating = 2.5f;
     int iRatingProjection = 0;
 };
 
-class IRSDKManager;
+// Drivers in race order, read in place from RelativeCalculator's per-CarIdx
+// table. The storage is fixed for the calculator's lifetime; the contents
+// change with getResultsVersion()
+class DriverView {
+public:
+    class iterator {
+    public:
+        iterator(const Driver* table, const uint8_t* at) : m_table(table), m_at(at) {}
+        const Driver& operator*() const { return m_table[*m_at]; }
+        const Driver* operator->() const { return &m_table[*m_at]; }
+        iterator& operator++() { ++m_at; return *this; }
+        bool operator==(const iterator& other) const { return m_at == other.m_at; }
+        bool operator!=(const iterator& other) const { return m_at != other.m_at; }
+
+    private:
+        const Driver* m_table;
+        const uint8_t* m_at;
+    };
+
+    DriverView() = default;
+    DriverView(const Driver* table, const uint8_t* order, int count) : m_table(table), m_order(order), m_count(count) {}
+
+    int size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    const Driver& operator[](int i) const { return m_table[m_order[i]]; }
+    iterator begin() const { return iterator(m_table, m_order); }
+    iterator end() const { return iterator(m_table, m_order + m_count); }
+
+private:
+    const Driver* m_table = nullptr;
+    const uint8_t* m_order = nullptr;
+    int m_count = 0;
+};
+
+// Where the player would rejoin if they pitted now, priced with the
+// track's pit-loss model (see PitTracker)
+struct PitRejoin {
+    bool valid = false;
+    float pitLoss = 0.0f;     // seconds, lane loss + mean stop
+    int position = 0;         // race position after the stop
+    int carAhead = -1;        // CarIdx, -1 = none
+    float gapAhead = 0.0f;    // seconds the player would be behind it
+    int carBehind = -1;
+    float gapBehind = 0.0f;   // seconds it would be behind the player
+};
+
+// How getRelative() picks its rows around the player
+enum class RelativeMode {
+    Race,   // neighbours in race order
+    Track,  // cars physically nearest on track, by circular distance
+};
 
 class RelativeCalculator {
 public:
+    // Classes past this share the last one
+    static constexpr int kMaxClasses = SessionTable::kMaxClasses;
+
     RelativeCalculator(IRSDKManager* sdk);
 
+    // Recomputes only when the SDK data version changed since the last
+    // call (or after invalidate()); otherwise counts a skipped update
     void update();
+    void invalidate() { m_invalidated = true; }
+
+    // Session info is parsed on a worker thread by default; synchronous
+    // parsing (inside update()) gives deterministic results for tools
+    void setSessionInfoAsync(bool async);
+    bool isSessionInfoAsync() const { return m_sessionWorker != nullptr; }
+
+    // CarIdx bitmask of drivers whose session info entry was added, removed
+    // or changed since the previous call
+    uint64_t takeChangedDrivers() { uint64_t m = m_changedDrivers; m_changedDrivers = 0; return m; }
 
-    const std::vector<Driver>& getAllDrivers() const { return m_allDrivers; }
-    std::vector<Driver> getRelative(int ahead = 4, int behind = 4) const;
+    // Changes whenever the results below change; widgets cache on it
+    uint64_t getResultsVersion() const { return m_resultsVersion; }
+    uint64_t getUpdatesComputed() const { return m_updatesComputed; }
+    uint64_t getUpdatesSkipped() const { return m_updatesSkipped; }
+
+    DriverView getAllDrivers() const { return DriverView(m_drivers, m_order.cars(), m_order.count()); }
+    // In Track mode (with the player on track) the rows are the player and
+    // the nearest cars around them; that view shares one buffer, so it is
+    // valid until the next getRelative() call
+    DriverView getRelative(int ahead = 4, int behind = 4) const;
+
+    void setRelativeMode(RelativeMode mode) { m_mode = mode; }
+    RelativeMode getRelativeMode() const { return m_mode; }
 
     int getPlayerCarIdx() const { return m_playerCarIdx; }
 
-    std::string getSeriesName() const;
+    // Resolves the string handles in Driver
+    const utils::StringPool& strings() const { return m_session->strings; }
+
+    const std::string& getSeriesName() const { return m_seriesName; }
     std::string getLapInfo() const;
     int getSOF() const;
 
+    // Car classes of the session by CarClassID, numbered in CarIdx order
+    // of first appearance (the pace car is not counted)
+    int getClassCount() const { return m_classCount; }
+    bool isMultiClass() const { return m_classCount > 1; }
+    int getClassSize(int classIndex) const;
+    int getClassSOF(int classIndex) const;
+    // The player's class SOF; the whole field's without a player on track
+    int getPlayerClassSOF() const;
+
+    // Completed laps of every car, with best/average/consistency
+    const LapHistory& getLapHistory() const { return m_lapHistory; }
+    // Sector splits from the session's SplitTimeInfo
+    const SectorTimer& getSectorTimer() const { return m_sectorTimer; }
+    // Player's live delta to their reference lap for this car and track
+    const LapDelta& getLapDelta() const { return m_lapDelta; }
+    // Pit stops of every car and the track's pit-loss model
+    const PitTracker& getPitTracker() const { return m_pitTracker; }
+    // Recomputed every tick; invalid until the model has seen a stop, or
+    // with the player off track or already on pit road
+    const PitRejoin& getPitRejoin() const { return m_pitRejoin; }
+
+    // Directory of the reference laps, one file per car/track; empty (the
+    // default) keeps them in memory for the session only
+    void setReferenceLapDir(const std::string& dir);
+
     // Player stats for footer
     int getPlayerIncidents() const { return m_playerIncidents; }
     float getPlayerLastLap() const { return m_playerLastLap; }
     float getPlayerBestLap() const { return m_playerBestLap; }
 
 private:
-    void updateSessionInfo();
-    void calculateGaps(const float* f2Times, int f2Count);
+    void resolveVarHandles();
+    bool updateSessionInfo();
+    void setSessionTable(std::shared_ptr<const SessionTable> table);
+    void bindDrivers();
+    void buildOrder();
+    void calculateClasses();
+    void bindField(int classIndex);
+    void calculateGaps();
+    float timeGap(int carIdx, int refIdx, bool& timed) const;
+    void calculateTrackGaps();
+    DriverView selectTrackRelative(int ahead, int behind) const;
+    void updateDriver(int carIdx, int relativePosition);
     void calculateiRatingProjections();
-    std::string getCarBrand(const std::string& carPath);
-    static float parseSafetyRatingFromLicString(const std::string& licString);
+    void bindLapDelta();
+    void calculatePitRejoin();
 
     IRSDKManager* m_sdk;
-    std::vector<Driver> m_allDrivers;
     int m_playerCarIdx = -1;
     int m_sof = 0;
     std::string m_seriesName;
@@ -74,8 +217,77 @@ private:
     float m_playerLastLap = -1.0f;
     float m_playerBestLap = -1.0f;
 
+    // Telemetry handles, re-resolved when the SDK header generation changes
+    int m_varGeneration = -1;
+    VarHandle m_varPlayerCarIdx;
+    VarHandle m_varLap;
+    VarHandle m_varSessionTime;
+    VarHandle m_varSessionTimeRemain;
+    VarHandle m_varIncidents;
+    VarHandle m_varLapLastLapTime;
+    VarHandle m_varLapBestLapTime;
+
+    // Per-tick CarIdx data and everything derived from it, indexed by
+    // CarIdx except m_order (CarIdx by race order, kept across ticks).
+    // m_drivers is the persistent table behind DriverView: the session
+    // fields are copied from SessionTable::cars by bindDrivers() on a table
+    // change, the rest is rewritten per tick for the cars in m_order
+    CarFrameReader m_frameReader;
+    CarFrame m_frame;
+    RaceOrder m_order;
+    bool m_playerInOrder = false;
+    float m_gapToLeader[CarFrame::kMaxCars] = {};
+    float m_gapToPlayer[CarFrame::kMaxCars] = {};
+    float m_gapToClassLeader[CarFrame::kMaxCars] = {};
+    uint64_t m_timedToPlayer = 0;  // CarIdx mask: m_gapToPlayer is in seconds, not laps
+    float m_trackDistance[CarFrame::kMaxCars] = {};
+    GapTimer m_gapTimer;  // time gaps when CarIdxF2Time is missing
+    LapHistory m_lapHistory;
+    SectorTimer m_sectorTimer;
+
+    PitTracker m_pitTracker;
+    PitRejoin m_pitRejoin;
+
+    // Reference lap of the player's car/track, reopened when either changes
+    LapDelta m_lapDelta;
+    std::string m_referenceLapDir;
+    std::string m_lapDeltaFile;  // file name of the open reference, empty = none
+    const SessionTable* m_lapDeltaSession = nullptr;
+    int m_lapDeltaPlayer = -1;
+    Driver m_drivers[CarFrame::kMaxCars];
+
+    // Track mode rows, selected on demand from the per-tick distances
+    RelativeMode m_mode = RelativeMode::Race;
+    mutable uint8_t m_trackRows[CarFrame::kMaxCars] = {};
+
+    // Dirty tracking against IRSDKManager::getDataVersion()
+    uint64_t m_dataVersion = 0;
+    uint64_t m_resultsVersion = 0;
+    bool m_invalidated = true;
+    uint64_t m_updatesComputed = 0;
+    uint64_t m_updatesSkipped = 0;
+
+    // Parsed session info; replaced as a whole, never modified in place
     int m_lastSessionInfoUpdate = -1;
-    std::map<int, utils::YAMLParser::DriverInfo> m_driverInfoMap;
+    std::shared_ptr<const SessionTable> m_session;
+    std::unique_ptr<SessionInfoWorker> m_sessionWorker;
+    std::string m_sessionYaml;  // copy buffer, swapped with the worker's
+    uint64_t m_changedDrivers = 0;
+
+    // Classes bound with the drivers, and per-tick class results
+    int m_classCount = 1;
+    int m_classSize[kMaxClasses] = {};
+    int m_classSof[kMaxClasses] = {};
+    int m_classLeader[kMaxClasses] = {};
+
+    // iRating fields per class, rebound when their members change; a
+    // car's slot is its index in its class field
+    bool m_fieldsStale = true;
+    uint64_t m_sofMembers = 0;
+    uint64_t m_paceCars = 0;  // CarIdx mask, kept out of classes and SOF
+    uint64_t m_classMembers[kMaxClasses] = {};
+    iRatingField m_classField[kMaxClasses];
+    uint8_t m_fieldSlot[CarFrame::kMaxCars] = {};
 };
 
 } // namespace iracing
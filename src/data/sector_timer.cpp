@@ -0,0 +1,161 @@
+#include "data/sector_timer.h"
+#include "data/lap_step.h"
+#include <algorithm>
+
+namespace iracing {
+
+SectorTimer::SectorTimer() {
+    reset();
+}
+
+void SectorTimer::setSectors(const float* starts, int count) {
+    float sorted[kMaxSectors + 1];
+    int n = 0;
+    sorted[n++] = 0.0f;
+    for (int i = 0; i < count && n <= kMaxSectors; ++i) {
+        const float s = starts[i];
+        if (s > 0.0f && s < 1.0f) sorted[n++] = s;
+    }
+    std::sort(sorted, sorted + n);
+    n = (int)(std::unique(sorted, sorted + n) - sorted);
+    n = std::min(n, kMaxSectors);
+
+    if (n == m_count && std::equal(sorted, sorted + n, m_starts)) return;
+    std::copy(sorted, sorted + n, m_starts);
+    m_count = n;
+    reset();
+}
+
+void SectorTimer::clearCar(Car& car) {
+    car = Car();
+    std::fill(car.last, car.last + kMaxSectors, -1.0f);
+    std::fill(car.best, car.best + kMaxSectors, -1.0f);
+}
+
+void SectorTimer::reset() {
+    for (Car& car : m_cars) clearCar(car);
+    std::fill(m_sessionBest, m_sessionBest + kMaxSectors, -1.0f);
+    std::fill(m_sessionBestCar, m_sessionBestCar + kMaxSectors, -1);
+    m_now = 0.0;
+}
+
+int SectorTimer::sectorAt(float pct) const {
+    int s = 0;
+    while (s + 1 < m_count && m_starts[s + 1] <= pct) ++s;
+    return s;
+}
+
+void SectorTimer::update(const CarFrame& f, double now) {
+    if (now < m_now) reset();
+    m_now = now;
+
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        Car& car = m_cars[i];
+        if (i >= f.carCount || !f.isInWorld(i) || f.lapDistPct[i] < 0.0f) {
+            car.valid = false;
+            continue;
+        }
+        const float pct = f.lapDistPct[i] >= 1.0f ? 0.0f : f.lapDistPct[i];
+        const bool onPit = f.onPitRoad[i] != 0;
+        if (!car.valid) {
+            car.valid = true;
+            car.sector = sectorAt(pct);
+            car.pct = pct;
+            car.time = now;
+            car.entered = -1.0;
+            car.pit = onPit;
+            continue;
+        }
+
+        const LapStep step(car.pct, pct);
+        if (step.kind == LapStep::Still) continue;
+        if (step.kind == LapStep::Jump) {
+            car.sector = sectorAt(pct);
+            car.pct = pct;
+            car.time = now;
+            car.entered = -1.0;
+            car.pit = onPit;
+            continue;
+        }
+
+        // Sector boundaries passed since the previous tick
+        const LapSpan span(car.pct, step, car.time, now);
+        double lap = 0.0;
+        for (;;) {
+            const int next = car.sector + 1 == m_count ? 0 : car.sector + 1;
+            const double boundary = (next == 0 ? 1.0 : m_starts[next]) + lap;
+            if (boundary > span.to()) break;
+            finishSector(i, span.at(boundary), onPit);
+            if (next == 0) lap += 1.0;
+        }
+        car.pit = car.pit || onPit;
+        car.pct = pct;
+        car.time = now;
+    }
+}
+
+void SectorTimer::finishSector(int carIdx, double at, bool onPit) {
+    Car& car = m_cars[carIdx];
+    const int s = car.sector;
+    if (car.entered >= 0.0) {
+        const float time = (float)(at - car.entered);
+        car.last[s] = time;
+        if (!car.pit && !onPit && time > 0.0f) {
+            if (car.best[s] < 0.0f) {
+                ++car.bests;
+                car.bestSum += time;
+                car.best[s] = time;
+            } else if (time < car.best[s]) {
+                car.bestSum += time - car.best[s];
+                car.best[s] = time;
+            }
+            if (m_sessionBest[s] < 0.0f || time < m_sessionBest[s]) {
+                m_sessionBest[s] = time;
+                m_sessionBestCar[s] = carIdx;
+            }
+        }
+    }
+    car.sector = s + 1 == m_count ? 0 : s + 1;
+    car.entered = at;
+    car.pit = onPit;
+}
+
+int SectorTimer::currentSector(int car) const {
+    return (car >= 0 && car < CarFrame::kMaxCars && m_cars[car].valid) ? m_cars[car].sector : -1;
+}
+
+float SectorTimer::lastSector(int car, int sector) const {
+    if (car < 0 || car >= CarFrame::kMaxCars || sector < 0 || sector >= m_count) return -1.0f;
+    return m_cars[car].last[sector];
+}
+
+float SectorTimer::bestSector(int car, int sector) const {
+    if (car < 0 || car >= CarFrame::kMaxCars || sector < 0 || sector >= m_count) return -1.0f;
+    return m_cars[car].best[sector];
+}
+
+float SectorTimer::theoreticalBest(int car) const {
+    if (car < 0 || car >= CarFrame::kMaxCars) return -1.0f;
+    const Car& c = m_cars[car];
+    return c.bests == m_count ? (float)c.bestSum : -1.0f;
+}
+
+float SectorTimer::sessionBestSector(int sector, int* car) const {
+    if (sector < 0 || sector >= m_count) {
+        if (car) *car = -1;
+        return -1.0f;
+    }
+    if (car) *car = m_sessionBestCar[sector];
+    return m_sessionBest[sector];
+}
+
+float SectorTimer::sessionTheoreticalBest() const {
+    double sum = 0.0;
+    for (int s = 0; s < m_count; ++s) {
+        if (m_sessionBest[s] < 0.0f) return -1.0f;
+        sum += m_sessionBest[s];
+    }
+    return (float)sum;
+}
+
+} // namespace iracing
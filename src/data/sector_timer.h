@@ -0,0 +1,78 @@
+#ifndef SECTOR_TIMER_H
+#define SECTOR_TIMER_H
+
+#include "data/car_frame.h"
+
+namespace iracing {
+
+// Sector splits of every car from the SplitTimeInfo boundaries. A car's
+// sector ends when its CarIdxLapDistPct passes the next boundary; the
+// crossing is interpolated in SessionTime between the two ticks, as the
+// GapTimer does for its bins. Per car it keeps the last and best time of
+// each sector and the theoretical best lap (the sum of the best sectors);
+// across cars the session-best sectors and their theoretical lap.
+//
+// Fixed memory, and update() is O(cars): a car crosses at most a couple
+// of boundaries per tick. Sectors that touched pit road or were entered
+// mid-way (join, tow, jump) are not timed into the bests.
+class SectorTimer {
+public:
+    static constexpr int kMaxSectors = 32;
+
+    SectorTimer();
+
+    // Sector start fractions as listed in SplitTimeInfo. Sorted, with a
+    // start at 0 added when missing and values outside [0, 1) dropped;
+    // past kMaxSectors they are cut. Timings are only forgotten when the
+    // boundaries actually change.
+    void setSectors(const float* starts, int count);
+    int sectorCount() const { return m_count; }
+    float sectorStart(int sector) const { return m_starts[sector]; }
+
+    // Forgets every timing, keeps the sectors (new session, reconnect)
+    void reset();
+
+    // A time going backwards resets; a car moving back or jumping more
+    // than a tenth of a lap in one tick restarts its current sector
+    void update(const CarFrame& frame, double sessionTime);
+
+    // Sector the car is in, -1 when not timed
+    int currentSector(int car) const;
+    // Seconds, < 0 when there is none yet
+    float lastSector(int car, int sector) const;
+    float bestSector(int car, int sector) const;
+    // Sum of the car's best sectors, < 0 until every sector has one
+    float theoreticalBest(int car) const;
+
+    float sessionBestSector(int sector, int* car = nullptr) const;
+    float sessionTheoreticalBest() const;
+
+private:
+    struct Car {
+        bool valid = false;
+        int sector = 0;
+        float pct = 0.0f;           // at the last update
+        double time = 0.0;
+        double entered = -1.0;      // when the current sector began, < 0 = joined mid-sector
+        bool pit = false;           // on pit road since then
+        int bests = 0;              // sectors with a best
+        double bestSum = 0.0;
+        float last[kMaxSectors];
+        float best[kMaxSectors];
+    };
+
+    int sectorAt(float pct) const;
+    void finishSector(int carIdx, double at, bool onPit);
+    static void clearCar(Car& car);
+
+    int m_count = 1;
+    float m_starts[kMaxSectors] = {};
+    Car m_cars[CarFrame::kMaxCars];
+    float m_sessionBest[kMaxSectors];
+    int m_sessionBestCar[kMaxSectors];
+    double m_now = 0.0;
+};
+
+} // namespace iracing
+
+#endif // SECTOR_TIMER_H
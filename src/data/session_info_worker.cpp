@@ -0,0 +1,236 @@
+#include "data/session_info_worker.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+namespace iracing {
+
+namespace {
+
+float parseSafetyRatingFromLicString(const std::string& ls) {
+    if (ls.empty()) return 2.5f;
+    float base = 2.0f;
+    switch (ls[0]) {
+        case 'R': base = 0.0f; break; case 'D': base = 1.0f; break;
+        case 'C': base = 2.0f; break; case 'B': base = 3.0f; break;
+        case 'A': base = 4.0f; break;
+    }
+    size_t ns = ls.find_first_of("0123456789.");
+    if (ns != std::string::npos) {
+        try {
+            float n = std::stof(ls.substr(ns));
+            return base + (n - (float)(int)n);
+        } catch (...) {}
+    }
+    return base + 0.5f;
+}
+
+std::string getCarBrand(const std::string& carPath) {
+    static const std::map<std::string, std::string> brands = {
+        {"bmw","bmw"},{"mercedes","mercedes"},{"audi","audi"},{"porsche","porsche"},
+        {"ferrari","ferrari"},{"lamborghini","lamborghini"},{"aston","aston_martin"},
+        {"mclaren","mclaren"},{"ford","ford"},{"chevrolet","chevrolet"},
+        {"toyota","toyota"},{"mazda","mazda"}
+    };
+    std::string lower = carPath;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    for (auto& [k, v] : brands) { if (lower.find(k) != std::string::npos) return v; }
+    return "unknown";
+}
+
+} // namespace
+
+SessionTable::SessionTable() {
+    std::fill(iRating, iRating + kMaxCars, 1500);
+}
+
+const utils::YAMLIndex& SessionTable::index() const {
+    // Shared between threads like the rest of the table, hence call_once
+    std::call_once(m_indexOnce, [this] { m_index.build(yaml); });
+    return m_index;
+}
+
+uint64_t SessionTable::changedDrivers(const SessionTable& other) const {
+    uint64_t mask = 0;
+    for (int i = 0; i < kMaxCars; ++i) {
+        if (byCarIdx[i].get() != other.byCarIdx[i].get()) mask |= 1ull << i;
+    }
+    return mask;
+}
+
+std::shared_ptr<const SessionTable> SessionTable::build(std::string_view yaml, int sessionInfoUpdate,
+                                                        const SessionTable* previous) {
+    using utils::YAMLParser;
+    auto table = std::make_shared<SessionTable>();
+    table->sessionInfoUpdate = sessionInfoUpdate;
+    table->yaml.assign(yaml.data(), yaml.size());
+
+    thread_local std::vector<YAMLParser::Block> sections;
+    thread_local std::vector<YAMLParser::Block> entries;
+    YAMLParser::splitSections(yaml, sections);
+
+    for (const auto& section : sections) {
+        if (section.name == "WeekendInfo") {
+            table->weekendHash = YAMLParser::hash(section.text);
+            if (previous && previous->weekendHash == table->weekendHash) {
+                table->seriesName = previous->seriesName;
+                table->trackName = previous->trackName;
+            } else {
+                auto info = YAMLParser::parse(section.text);
+                table->seriesName = std::move(info.seriesName);
+                table->trackName = std::move(info.trackName);
+            }
+        } else if (section.name == "SessionInfo") {
+            table->sessionHash = YAMLParser::hash(section.text);
+            if (previous && previous->sessionHash == table->sessionHash) {
+                table->sessionLaps = previous->sessionLaps;
+                table->sessionTime = previous->sessionTime;
+            } else {
+                auto info = YAMLParser::parse(section.text);
+                table->sessionLaps = info.sessionLaps;
+                table->sessionTime = info.sessionTime;
+            }
+        } else if (section.name == "SplitTimeInfo") {
+            table->splitTimeHash = YAMLParser::hash(section.text);
+            if (previous && previous->splitTimeHash == table->splitTimeHash) {
+                table->sectorStarts = previous->sectorStarts;
+            } else {
+                table->sectorStarts = YAMLParser::parse(section.text).sectorStarts;
+            }
+        } else if (section.name == "DriverInfo") {
+            // Entries are compared one by one; no section-wide hash, which
+            // would read the largest section twice
+            YAMLParser::splitDrivers(section.text, entries);
+            for (const auto& entry : entries) {
+                const int idx = entry.carIdx;
+                if (idx < 0 || idx >= kMaxCars) continue;  // parse() would not index it either
+                if (previous && previous->byCarIdx[idx] && previous->driverHash[idx] == entry.hash) {
+                    table->byCarIdx[idx] = previous->byCarIdx[idx];
+                } else {
+                    table->byCarIdx[idx] = std::make_shared<const DriverInfo>(YAMLParser::parseDriver(entry.text));
+                    ++table->reparsedDrivers;
+                }
+                table->driverHash[idx] = entry.hash;  // a repeated CarIdx: last entry wins
+            }
+        }
+    }
+
+    for (int i = 0; i < kMaxCars; ++i) {
+        if (!table->byCarIdx[i]) continue;
+        table->drivers.push_back(table->byCarIdx[i].get());
+        table->iRating[i] = table->byCarIdx[i]->iRating;
+    }
+    table->bindCars();
+    return table;
+}
+
+void SessionTable::bindCars() {
+    int classId[kMaxClasses] = {};
+    classCount = 0;
+    char buf[32];
+
+    for (int i = 0; i < kMaxCars; ++i) {
+        Car& car = cars[i];
+        snprintf(buf, sizeof(buf), "%d", i + 1);
+        const utils::StringId fallbackNumber = strings.intern(buf);
+
+        if (const auto* info = driver(i)) {
+            const auto& di = *info;
+            car.carNumber = di.carNumber.empty() ? fallbackNumber : strings.intern(di.carNumber);
+            car.driverName = strings.intern(di.userName.empty() ? "Unknown" : di.userName);
+            car.iRating = di.iRating;
+            car.estLapTime = di.carClassEstLapTime;
+            car.countryCode = strings.intern(di.countryCode);
+
+            if (di.licSubLevel > 0) {
+                car.safetyRating = static_cast<float>(di.licSubLevel) / 100.0f;
+            } else if (!di.licString.empty()) {
+                car.safetyRating = parseSafetyRatingFromLicString(di.licString);
+            } else {
+                if (di.licenseLevel >= 1 && di.licenseLevel <= 20) {
+                    int cb = ((di.licenseLevel - 1) / 4);
+                    int sl = ((di.licenseLevel - 1) % 4);
+                    car.safetyRating = (float)cb + sl * 0.25f;
+                } else {
+                    car.safetyRating = 2.5f;
+                }
+            }
+            car.carBrand = strings.intern(getCarBrand(di.carPath));
+            car.carClass = strings.intern(di.carClassShortName.empty() ? "???" : di.carClassShortName);
+
+            if (di.isPaceCar) {
+                car.classIndex = kNoClass;
+                paceCars |= 1ull << i;
+            } else {
+                int c = 0;
+                while (c < classCount && classId[c] != di.carClassId) ++c;
+                if (c == classCount) {
+                    if (classCount < kMaxClasses) classId[classCount++] = di.carClassId;
+                    else c = kMaxClasses - 1;
+                }
+                car.classIndex = c;
+            }
+        } else {
+            snprintf(buf, sizeof(buf), "Driver %d", i);
+            car.carNumber = fallbackNumber;
+            car.driverName = strings.intern(buf);
+            car.carBrand = strings.intern("unknown");
+            car.carClass = strings.intern("Unknown");
+        }
+    }
+    if (classCount == 0) classCount = 1;
+}
+
+SessionInfoWorker::SessionInfoWorker()
+    : m_latest(SessionTable::build({}, -1))
+{
+    m_thread = std::thread(&SessionInfoWorker::run, this);
+}
+
+SessionInfoWorker::~SessionInfoWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void SessionInfoWorker::submit(std::string& yaml, int sessionInfoUpdate) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasPending) m_superseded.fetch_add(1);
+        m_pending.swap(yaml);
+        m_pendingUpdate = sessionInfoUpdate;
+        m_hasPending = true;
+    }
+    m_wake.notify_one();
+}
+
+std::shared_ptr<const SessionTable> SessionInfoWorker::latest() const {
+    return std::atomic_load(&m_latest);
+}
+
+void SessionInfoWorker::run() {
+    std::string yaml;
+    for (;;) {
+        int update = -1;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || m_hasPending; });
+            if (m_stop) return;
+            yaml.swap(m_pending);
+            update = m_pendingUpdate;
+            m_hasPending = false;
+        }
+
+        // Keep the replaced table until the next publish: the render thread
+        // then normally drops a table that is not the last reference, and
+        // freeing its strings happens here instead of inside update()
+        auto table = SessionTable::build(yaml, update, std::atomic_load(&m_latest).get());
+        m_retired = std::atomic_exchange(&m_latest, std::shared_ptr<const SessionTable>(table));
+        m_parsed.fetch_add(1);
+    }
+}
+
+} // namespace iracing
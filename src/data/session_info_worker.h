@@ -0,0 +1,143 @@
+#ifndef SESSION_INFO_WORKER_H
+#define SESSION_INFO_WORKER_H
+
+#include "utils/string_pool.h"
+#include "utils/yaml_index.h"
+#include "utils/yaml_parser.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace iracing {
+
+// Everything the calculators need from one session info string, parsed
+// once. Immutable after build(): it is shared between the worker and the
+// render thread, and a newer table replaces it instead of mutating it.
+//
+// build() against the previous table only reparses what changed: sections
+// whose content hash matches are carried over, and inside DriverInfo each
+// "- CarIdx:" entry is hashed on its own so unchanged drivers keep the
+// previous table's DriverInfo object. Comparing byCarIdx pointers between
+// two tables therefore tells which drivers changed.
+//
+// build() also binds what RelativeCalculator shows of every CarIdx (names
+// interned, safety rating, brand, class numbering), so adopting a new
+// table on the render thread is a copy of cars[].
+struct SessionTable {
+    using DriverInfo = utils::YAMLParser::DriverInfo;
+    static constexpr int kMaxCars = 64;
+    // Classes past this share the last one
+    static constexpr int kMaxClasses = 8;
+    static constexpr int kNoClass = -1;
+
+    // A CarIdx's session fields; the strings are ids into strings. CarIdx
+    // without a DriverInfo entry get placeholders
+    struct Car {
+        utils::StringId carNumber = utils::kEmptyString;
+        utils::StringId driverName = utils::kEmptyString;
+        utils::StringId carClass = utils::kEmptyString;
+        utils::StringId carBrand = utils::kEmptyString;
+        utils::StringId countryCode = utils::kEmptyString;
+        int iRating = 1500;
+        float safetyRating = 2.5f;
+        float estLapTime = 0.0f;  // CarClassEstLapTime, 0 = unknown
+        int classIndex = 0;       // CarClassIDs numbered in CarIdx order, kNoClass for the pace car
+    };
+
+    int sessionInfoUpdate = -1;
+    std::string seriesName;
+    std::string trackName;
+    int sessionLaps = 0;
+    float sessionTime = 0.0f;
+    std::vector<float> sectorStarts;  // SplitTimeInfo, as listed
+
+    std::vector<const DriverInfo*> drivers;                 // CarIdx order
+    std::shared_ptr<const DriverInfo> byCarIdx[kMaxCars];   // owns the entries
+    int iRating[kMaxCars];                                  // 1500 when unknown
+
+    Car cars[kMaxCars];
+    int classCount = 1;
+    uint64_t paceCars = 0;  // CarIdx mask
+    utils::StringPool strings;
+
+    // Content hashes of the blocks this table was built from
+    uint64_t weekendHash = 0;
+    uint64_t sessionHash = 0;
+    uint64_t splitTimeHash = 0;
+    uint64_t driverHash[kMaxCars] = {};
+
+    int reparsedDrivers = 0;  // entries parsed by build(); the rest were shared
+
+    // The session string itself, for fields the table does not extract:
+    // query it by path through index(), built on first use
+    std::string yaml;
+    const utils::YAMLIndex& index() const;
+
+    SessionTable();
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    const DriverInfo* driver(int carIdx) const {
+        return (carIdx >= 0 && carIdx < kMaxCars) ? byCarIdx[carIdx].get() : nullptr;
+    }
+
+    // CarIdx bitmask of drivers added, removed or changed from other
+    uint64_t changedDrivers(const SessionTable& other) const;
+
+    static std::shared_ptr<const SessionTable> build(std::string_view yaml, int sessionInfoUpdate,
+                                                     const SessionTable* previous = nullptr);
+
+private:
+    void bindCars();
+
+    mutable std::once_flag m_indexOnce;
+    mutable utils::YAMLIndex m_index;
+};
+
+// Parses session info off the render thread. submit() hands over a copy
+// of the YAML (latest wins, an unparsed older one is superseded); the
+// worker builds a SessionTable and publishes it with an atomic shared_ptr
+// store that latest() picks up without locking against the parse.
+class SessionInfoWorker {
+public:
+    SessionInfoWorker();
+    ~SessionInfoWorker();
+
+    SessionInfoWorker(const SessionInfoWorker&) = delete;
+    SessionInfoWorker& operator=(const SessionInfoWorker&) = delete;
+
+    // Takes the contents of yaml by swapping buffers, so the caller's
+    // string gets the previous buffer back and no allocation is needed
+    void submit(std::string& yaml, int sessionInfoUpdate);
+
+    std::shared_ptr<const SessionTable> latest() const;
+
+    uint64_t parsedCount() const { return m_parsed.load(); }
+    uint64_t supersededCount() const { return m_superseded.load(); }
+
+private:
+    void run();
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+    bool m_hasPending = false;
+    std::string m_pending;
+    int m_pendingUpdate = -1;
+
+    std::shared_ptr<const SessionTable> m_latest;  // std::atomic_load/exchange only
+    std::shared_ptr<const SessionTable> m_retired; // worker thread only
+    std::atomic<uint64_t> m_parsed{0};
+    std::atomic<uint64_t> m_superseded{0};
+};
+
+} // namespace iracing
+
+#endif // SESSION_INFO_WORKER_H
@@ -0,0 +1,172 @@
+#include "data/telemetry_transport.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <ctime>
+    #ifdef __linux__
+        #include <linux/futex.h>
+        #include <sys/syscall.h>
+    #endif
+#endif
+
+namespace iracing {
+
+#ifdef _WIN32
+
+// Live sim memory: named file mapping + auto-reset data-valid event
+class Win32SharedMemoryTransport : public TelemetryTransport {
+public:
+    ~Win32SharedMemoryTransport() override { close(); }
+
+    bool open() override {
+        m_hMemMapFile = OpenFileMapping(FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
+        if (!m_hMemMapFile) {
+            return false;
+        }
+
+        m_pSharedMem = (const char*)MapViewOfFile(m_hMemMapFile, FILE_MAP_READ, 0, 0, 0);
+        if (!m_pSharedMem) {
+            CloseHandle(m_hMemMapFile);
+            m_hMemMapFile = nullptr;
+            return false;
+        }
+
+        MEMORY_BASIC_INFORMATION info = {};
+        if (VirtualQuery(m_pSharedMem, &info, sizeof(info))) {
+            m_size = info.RegionSize;
+        }
+
+        // Try to open the event (optional – we have polling fallback)
+        m_hDataValidEvent = OpenEvent(SYNCHRONIZE, FALSE, IRSDK_DATAVALIDEVENTNAME);
+        return true;
+    }
+
+    void close() override {
+        if (m_pSharedMem) UnmapViewOfFile(m_pSharedMem);
+        if (m_hMemMapFile) CloseHandle(m_hMemMapFile);
+        if (m_hDataValidEvent) CloseHandle(m_hDataValidEvent);
+
+        m_pSharedMem = nullptr;
+        m_hMemMapFile = nullptr;
+        m_hDataValidEvent = nullptr;
+        m_size = 0;
+    }
+
+    const char* data() const override { return m_pSharedMem; }
+    size_t size() const override { return m_size; }
+
+    bool waitForDataValid(int timeoutMS) override {
+        if (!m_hDataValidEvent) return false;
+        return WaitForSingleObject(m_hDataValidEvent, timeoutMS) == WAIT_OBJECT_0;
+    }
+
+    bool hasDataValidSignal() const override { return m_hDataValidEvent != nullptr; }
+
+private:
+    HANDLE m_hMemMapFile = nullptr;
+    HANDLE m_hDataValidEvent = nullptr;
+    const char* m_pSharedMem = nullptr;
+    size_t m_size = 0;
+};
+
+std::unique_ptr<TelemetryTransport> createSharedMemoryTransport() {
+    return std::make_unique<Win32SharedMemoryTransport>();
+}
+
+#else
+
+// Local publisher memory: shm_open + mmap, with a futex on a sequence word
+// in a second shm object standing in for the Win32 event
+class PosixSharedMemoryTransport : public TelemetryTransport {
+public:
+    ~PosixSharedMemoryTransport() override { close(); }
+
+    bool open() override {
+        int fd = shm_open(IRSDK_POSIX_MEMMAPFILENAME, O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st = {};
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(irsdk_header)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* mem = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) {
+            return false;
+        }
+        m_pSharedMem = static_cast<const char*>(mem);
+        m_size = (size_t)st.st_size;
+
+        // Signal is optional – we have polling fallback
+        int sfd = shm_open(IRSDK_POSIX_DATAVALIDEVENTNAME, O_RDWR, 0);
+        if (sfd >= 0) {
+            void* sig = mmap(nullptr, sizeof(PosixDataValidSignal), PROT_READ | PROT_WRITE, MAP_SHARED, sfd, 0);
+            ::close(sfd);
+            if (sig != MAP_FAILED) {
+                m_signal = static_cast<PosixDataValidSignal*>(sig);
+                m_lastSequence = m_signal->sequence.load(std::memory_order_acquire);
+            }
+        }
+        return true;
+    }
+
+    void close() override {
+        if (m_pSharedMem) munmap(const_cast<char*>(m_pSharedMem), m_size);
+        if (m_signal) munmap(m_signal, sizeof(PosixDataValidSignal));
+
+        m_pSharedMem = nullptr;
+        m_signal = nullptr;
+        m_size = 0;
+    }
+
+    const char* data() const override { return m_pSharedMem; }
+    size_t size() const override { return m_size; }
+
+    bool waitForDataValid(int timeoutMS) override {
+        if (!m_signal) return false;
+
+        if (consumeSignal()) return true;
+        if (timeoutMS <= 0) return false;
+
+#ifdef __linux__
+        timespec timeout = { timeoutMS / 1000, (long)(timeoutMS % 1000) * 1000000L };
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_signal->sequence), FUTEX_WAIT,
+                m_lastSequence, &timeout, nullptr, 0);
+#else
+        usleep(1000);
+#endif
+        return consumeSignal();
+    }
+
+    bool hasDataValidSignal() const override { return m_signal != nullptr; }
+
+private:
+    bool consumeSignal() {
+        uint32_t sequence = m_signal->sequence.load(std::memory_order_acquire);
+        if (sequence == m_lastSequence) return false;
+        m_lastSequence = sequence;
+        return true;
+    }
+
+    const char* m_pSharedMem = nullptr;
+    size_t m_size = 0;
+    PosixDataValidSignal* m_signal = nullptr;
+    uint32_t m_lastSequence = 0;
+};
+
+std::unique_ptr<TelemetryTransport> createSharedMemoryTransport() {
+    return std::make_unique<PosixSharedMemoryTransport>();
+}
+
+#endif
+
+} // namespace iracing
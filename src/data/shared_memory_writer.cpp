@@ -0,0 +1,123 @@
+#include "data/shared_memory_writer.h"
+#include "data/telemetry_transport.h"
+#include <cstring>
+#include <climits>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #ifdef __linux__
+        #include <linux/futex.h>
+        #include <sys/syscall.h>
+    #endif
+#endif
+
+namespace iracing {
+
+SharedMemoryWriter::~SharedMemoryWriter() {
+    destroy();
+}
+
+#ifdef _WIN32
+
+bool SharedMemoryWriter::create(size_t size) {
+    destroy();
+
+    HANDLE mapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       (DWORD)((unsigned long long)size >> 32), (DWORD)(size & 0xFFFFFFFF),
+                                       IRSDK_MEMMAPFILENAME);
+    if (!mapping) return false;
+
+    m_data = (char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!m_data) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_size = size;
+    memset(m_data, 0, size);
+    m_signal = CreateEvent(nullptr, FALSE, FALSE, IRSDK_DATAVALIDEVENTNAME);
+    return true;
+}
+
+void SharedMemoryWriter::destroy() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle((HANDLE)m_mapping);
+    if (m_signal) CloseHandle((HANDLE)m_signal);
+
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_signal = nullptr;
+    m_size = 0;
+}
+
+void SharedMemoryWriter::signalDataValid() {
+    if (m_signal) SetEvent((HANDLE)m_signal);
+}
+
+#else
+
+bool SharedMemoryWriter::create(size_t size) {
+    destroy();
+
+    int fd = shm_open(IRSDK_POSIX_MEMMAPFILENAME, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return false;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+
+    m_data = static_cast<char*>(mem);
+    m_size = size;
+    memset(m_data, 0, size);
+
+    int sfd = shm_open(IRSDK_POSIX_DATAVALIDEVENTNAME, O_CREAT | O_RDWR, 0666);
+    if (sfd >= 0) {
+        if (ftruncate(sfd, sizeof(PosixDataValidSignal)) == 0) {
+            void* sig = mmap(nullptr, sizeof(PosixDataValidSignal), PROT_READ | PROT_WRITE, MAP_SHARED, sfd, 0);
+            if (sig != MAP_FAILED) m_signal = sig;
+        }
+        ::close(sfd);
+    }
+    return true;
+}
+
+void SharedMemoryWriter::destroy() {
+    if (m_data) {
+        munmap(m_data, m_size);
+        shm_unlink(IRSDK_POSIX_MEMMAPFILENAME);
+    }
+    if (m_signal) {
+        munmap(m_signal, sizeof(PosixDataValidSignal));
+        shm_unlink(IRSDK_POSIX_DATAVALIDEVENTNAME);
+    }
+
+    m_data = nullptr;
+    m_signal = nullptr;
+    m_size = 0;
+}
+
+void SharedMemoryWriter::signalDataValid() {
+    if (!m_signal) return;
+
+    auto* signal = static_cast<PosixDataValidSignal*>(m_signal);
+    signal->sequence.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal->sequence), FUTEX_WAKE, INT_MAX,
+            nullptr, nullptr, 0);
+#endif
+}
+
+#endif
+
+} // namespace iracing
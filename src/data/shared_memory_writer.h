@@ -0,0 +1,37 @@
+#ifndef SHARED_MEMORY_WRITER_H
+#define SHARED_MEMORY_WRITER_H
+
+#include <cstddef>
+
+namespace iracing {
+
+// Publisher side of the shared-memory transport. Creates the same named
+// mapping and data-valid signal the sim would, so local tools can feed
+// IRSDKManager without iRacing running.
+class SharedMemoryWriter {
+public:
+    SharedMemoryWriter() = default;
+    ~SharedMemoryWriter();
+
+    SharedMemoryWriter(const SharedMemoryWriter&) = delete;
+    SharedMemoryWriter& operator=(const SharedMemoryWriter&) = delete;
+
+    bool create(size_t size);
+    void destroy();
+
+    char* data() { return m_data; }
+    size_t size() const { return m_size; }
+
+    // Wake readers blocked in TelemetryTransport::waitForDataValid()
+    void signalDataValid();
+
+private:
+    char* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_signal = nullptr;  // HANDLE on Win32, PosixDataValidSignal* elsewhere
+    void* m_mapping = nullptr; // HANDLE on Win32
+};
+
+} // namespace iracing
+
+#endif // SHARED_MEMORY_WRITER_H
@@ -0,0 +1,86 @@
+#include "data/snapshot_ring.h"
+#include <new>
+
+namespace iracing {
+
+SnapshotRing::SnapshotRing(int slotCount, int rowSize)
+    : m_rowSize(rowSize > 0 ? rowSize : 0)
+{
+    uint32_t count = 2;
+    while (count < static_cast<uint32_t>(slotCount)) count <<= 1;
+    m_mask = count - 1;
+
+    // One contiguous allocation, each row starting on its own cache line
+    size_t stride = (static_cast<size_t>(m_rowSize) + kAlignment - 1) & ~(kAlignment - 1);
+    if (stride == 0) stride = kAlignment;
+    m_storage = static_cast<char*>(::operator new(stride * count, std::align_val_t(kAlignment)));
+
+    m_slots.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_slots[i].data = m_storage + stride * i;
+    }
+}
+
+SnapshotRing::~SnapshotRing() {
+    ::operator delete(m_storage, std::align_val_t(kAlignment));
+}
+
+int SnapshotRing::pending() const {
+    uint32_t head = m_head.load(std::memory_order_acquire);
+    uint32_t tail = m_tail.load(std::memory_order_acquire);
+    return static_cast<int>(head - tail);
+}
+
+SnapshotRing::Slot* SnapshotRing::acquireWrite() {
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail > m_mask) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &m_slots[head & m_mask];
+}
+
+void SnapshotRing::commitWrite() {
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    m_head.store(head + 1, std::memory_order_release);
+    m_produced.fetch_add(1, std::memory_order_relaxed);
+}
+
+const SnapshotRing::Slot* SnapshotRing::peek() const {
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_acquire);
+    if (tail == head) return nullptr;
+    return &m_slots[tail & m_mask];
+}
+
+void SnapshotRing::pop() {
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_consumed.fetch_add(1, std::memory_order_relaxed);
+}
+
+const SnapshotRing::Slot* SnapshotRing::peekLatest() {
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_acquire);
+    if (tail == head) return nullptr;
+
+    // Release the older rows in one store so the producer can reuse them
+    uint32_t skipped = head - tail - 1;
+    if (skipped > 0) {
+        m_tail.store(head - 1, std::memory_order_release);
+        m_consumed.fetch_add(skipped, std::memory_order_relaxed);
+    }
+    return &m_slots[(head - 1) & m_mask];
+}
+
+SnapshotRing::Stats SnapshotRing::stats() const {
+    Stats s;
+    s.produced = m_produced.load(std::memory_order_relaxed);
+    s.consumed = m_consumed.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+    s.missed = m_missed.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace iracing
@@ -0,0 +1,76 @@
+#ifndef SNAPSHOT_RING_H
+#define SNAPSHOT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace iracing {
+
+// Lock-free single-producer / single-consumer ring of telemetry rows.
+//
+// The producer (ingest thread) copies rows straight into a free slot with
+// acquireWrite()/commitWrite(); the consumer (render thread) reads slots in
+// order with peek()/pop(). A full ring never blocks the producer: the new
+// row is dropped and counted instead.
+class SnapshotRing {
+public:
+    struct Slot {
+        char* data = nullptr;
+        int size = 0;
+        int tickCount = -1;
+        int sessionInfoUpdate = 0;
+    };
+
+    struct Stats {
+        uint64_t produced = 0;  // rows committed by the producer
+        uint64_t consumed = 0;  // rows popped by the consumer
+        uint64_t dropped = 0;   // rows lost because the ring was full
+        uint64_t missed = 0;    // source ticks the producer never saw
+    };
+
+    // slotCount is rounded up to a power of two
+    SnapshotRing(int slotCount, int rowSize);
+    ~SnapshotRing();
+
+    SnapshotRing(const SnapshotRing&) = delete;
+    SnapshotRing& operator=(const SnapshotRing&) = delete;
+
+    int rowSize() const { return m_rowSize; }
+    int capacity() const { return static_cast<int>(m_slots.size()); }
+    int pending() const;
+
+    // Producer side
+    Slot* acquireWrite();   // nullptr when full (counted as dropped)
+    void commitWrite();
+    void addMissed(uint64_t ticks) { m_missed.fetch_add(ticks, std::memory_order_relaxed); }
+
+    // Consumer side
+    const Slot* peek() const;  // nullptr when empty
+    void pop();
+    const Slot* peekLatest();  // pops everything but the newest row
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t kAlignment = 64;
+
+    std::vector<Slot> m_slots;
+    char* m_storage = nullptr;
+    int m_rowSize = 0;
+    uint32_t m_mask = 0;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<uint32_t> m_head{0};
+    std::atomic<uint64_t> m_produced{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_missed{0};
+
+    alignas(64) std::atomic<uint32_t> m_tail{0};
+    std::atomic<uint64_t> m_consumed{0};
+};
+
+} // namespace iracing
+
+#endif // SNAPSHOT_RING_H
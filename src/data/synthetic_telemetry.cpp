@@ -0,0 +1,431 @@
+#include "data/synthetic_telemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace iracing {
+
+namespace {
+
+constexpr double kSessionSeconds = 3600.0;
+constexpr double kGridGap = 0.002;          // laps between grid slots
+constexpr double kPitEntryPct = 0.95;
+constexpr double kPitExitPct = 0.05;
+constexpr double kPitLaneSpeed = 0.5;       // fraction of racing speed
+constexpr double kJoinStallSeconds = 5.0;
+
+const char* kClubs[] = { "ES", "NL", "US", "DE", "GB", "FR", "IT", "BR", "AU", "JP" };
+
+struct CarClass {
+    int id;
+    const char* shortName;
+    const char* carPath;
+    const char* screenName;
+    double pace;  // lap time relative to the reference lap
+};
+
+const CarClass kClasses[] = {
+    { 1, "GT3", "bmwm4gt3", "BMW M4 GT3", 1.00 },
+    { 2, "GTP", "porsche963gtp", "Porsche 963 GTP", 0.86 },
+    { 3, "LMP2", "dallarap217", "Dallara P217", 0.92 },
+    { 4, "GT4", "mclaren570sgt4", "McLaren 570S GT4", 1.08 },
+    { 5, "TCR", "audirs3lms", "Audi RS 3 LMS", 1.14 },
+};
+constexpr int kClassCount = (int)(sizeof(kClasses) / sizeof(kClasses[0]));
+
+} // namespace
+
+SyntheticTelemetry::SyntheticTelemetry(const Config& config)
+    : m_config(config)
+{
+    m_config.tickRate = std::max(1, m_config.tickRate);
+    m_config.cars = std::min(std::max(1, m_config.cars), m_config.paceCar ? kMaxCars - 1 : kMaxCars);
+    if (m_config.initialCars <= 0 || m_config.initialCars > m_config.cars) {
+        m_config.initialCars = m_config.cars;
+    }
+    m_config.classes = std::min(std::max(1, m_config.classes), kClassCount);
+
+    // splitmix64 step so nearby seeds still give unrelated sequences
+    uint64_t z = m_config.seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    m_rngState = (z ^ (z >> 31)) | 1;
+
+    m_layout.setTickRate(m_config.tickRate);
+    m_offSessionTime = m_layout.addVar("SessionTime", irsdk_double, 1, "s");
+    m_offSessionTick = m_layout.addVar("SessionTick", irsdk_int);
+    m_offSessionTimeRemain = m_layout.addVar("SessionTimeRemain", irsdk_double, 1, "s");
+    m_offPlayerCarIdx = m_layout.addVar("PlayerCarIdx", irsdk_int);
+    m_offIncidents = m_layout.addVar("PlayerCarMyIncidentCount", irsdk_int);
+    m_offLap = m_layout.addVar("Lap", irsdk_int);
+    m_offLapLastLapTime = m_layout.addVar("LapLastLapTime", irsdk_float, 1, "s");
+    m_offLapBestLapTime = m_layout.addVar("LapBestLapTime", irsdk_float, 1, "s");
+    m_offCarIdxOnPitRoad = m_layout.addVar("CarIdxOnPitRoad", irsdk_bool, kMaxCars);
+    m_offCarIdxLap = m_layout.addVar("CarIdxLap", irsdk_int, kMaxCars);
+    m_offCarIdxLapCompleted = m_layout.addVar("CarIdxLapCompleted", irsdk_int, kMaxCars);
+    m_offCarIdxPosition = m_layout.addVar("CarIdxPosition", irsdk_int, kMaxCars);
+    m_offCarIdxClassPosition = m_layout.addVar("CarIdxClassPosition", irsdk_int, kMaxCars);
+    m_offCarIdxLapDistPct = m_layout.addVar("CarIdxLapDistPct", irsdk_float, kMaxCars, "%");
+    m_offCarIdxF2Time = m_layout.addVar("CarIdxF2Time", irsdk_float, kMaxCars, "s");
+    m_offCarIdxLastLapTime = m_layout.addVar("CarIdxLastLapTime", irsdk_float, kMaxCars, "s");
+    m_offCarIdxBestLapTime = m_layout.addVar("CarIdxBestLapTime", irsdk_float, kMaxCars, "s");
+    m_offCarIdxTrackSurface = m_layout.addVar("CarIdxTrackSurface", irsdk_int, kMaxCars);
+    m_offWriterTimestamp = m_layout.addVar("WriterTimestamp", irsdk_double, 1, "s",
+                                           "Writer steady clock, for latency measurement");
+    m_layout.finalize();
+
+    // Driver identities are drawn up front so a join never shifts the
+    // random sequence of the cars already on track
+    for (int i = 0; i < kMaxCars; ++i) {
+        Driver& d = m_drivers[i];
+        d.iRating = (int)std::min(8000.0, std::max(600.0, 2000.0 + gaussian() * 800.0));
+        d.licLevel = 1 + (int)(uniform() * 20);
+        d.licSubLevel = (int)(uniform() * 500);
+        d.club = (int)(uniform() * (sizeof(kClubs) / sizeof(kClubs[0])));
+        m_cars[i].pace = (1.0 + std::fabs(gaussian()) * 0.015) * kClasses[i % m_config.classes].pace;
+    }
+
+    m_order.reserve(kMaxCars);
+    for (int i = 0; i < m_config.initialCars; ++i) {
+        joinCar(i, (m_config.initialCars - i) * kGridGap);
+        m_cars[i].state = CarState::Racing;
+        m_cars[i].stallTicks = 0;
+    }
+    m_nextJoinTime = m_config.joinInterval;
+    buildSessionInfo();
+}
+
+uint64_t SyntheticTelemetry::nextRandom() {
+    m_rngState ^= m_rngState >> 12;
+    m_rngState ^= m_rngState << 25;
+    m_rngState ^= m_rngState >> 27;
+    return m_rngState * 0x2545F4914F6CDD1Dull;
+}
+
+double SyntheticTelemetry::uniform() {
+    return (nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double SyntheticTelemetry::gaussian() {
+    // Irwin-Hall with n=4, rescaled to unit variance
+    double sum = uniform() + uniform() + uniform() + uniform();
+    return (sum - 2.0) * 1.7320508075688772;
+}
+
+void SyntheticTelemetry::init(char* mem) {
+    m_layout.init(mem);
+    IRSDKLayout::writeSessionInfo(mem, m_sessionInfo.c_str(), m_sessionInfo.size());
+    IRSDKLayout::setConnected(mem, true);
+    writeRow(IRSDKLayout::rowForTick(mem, m_tick), 0.0);
+    IRSDKLayout::commitRow(mem, m_tick);
+}
+
+bool SyntheticTelemetry::step(char* mem, double timestamp) {
+    ++m_tick;
+    const double dt = 1.0 / m_config.tickRate;
+    const double now = sessionTime();
+
+    bool joined = false;
+    while (m_activeCars < m_config.cars && m_config.joinInterval > 0.0 && now >= m_nextJoinTime) {
+        joinCar(m_activeCars, 0.0);
+        m_nextJoinTime += m_config.joinInterval;
+        joined = true;
+    }
+
+    for (int carIdx : m_order) advanceCar(m_cars[carIdx], dt);
+    sortByProgress();
+
+    if (joined) {
+        buildSessionInfo();
+        IRSDKLayout::writeSessionInfo(mem, m_sessionInfo.c_str(), m_sessionInfo.size());
+    }
+
+    writeRow(IRSDKLayout::rowForTick(mem, m_tick), timestamp);
+    IRSDKLayout::commitRow(mem, m_tick);
+    return joined;
+}
+
+void SyntheticTelemetry::joinCar(int carIdx, double progress) {
+    Car& car = m_cars[carIdx];
+    car.progress = progress;
+    car.lapStart = sessionTime();
+    car.lastLap = car.bestLap = -1.0f;
+    car.pitNext = false;
+
+    // Late joiners appear in their pit stall
+    car.state = CarState::Stall;
+    car.stallTicks = (int)(kJoinStallSeconds * m_config.tickRate);
+
+    m_order.push_back(carIdx);
+    m_activeCars = carIdx + 1;
+}
+
+void SyntheticTelemetry::advanceCar(Car& car, double dt) {
+    if (car.state == CarState::Stall) {
+        if (--car.stallTicks <= 0) car.state = CarState::PitLaneOut;
+        return;
+    }
+
+    double speed = (1.0 + gaussian() * 0.002) / (m_config.lapTime * car.pace);
+    if (car.state != CarState::Racing) speed *= kPitLaneSpeed;
+
+    const int lapBefore = (int)std::floor(car.progress);
+    car.progress += speed * dt;
+    const double pct = car.progress - std::floor(car.progress);
+
+    if ((int)std::floor(car.progress) != lapBefore) {
+        const double now = sessionTime();
+        if (lapBefore >= 0) {
+            car.lastLap = (float)(now - car.lapStart);
+            if (car.bestLap < 0.0f || car.lastLap < car.bestLap) car.bestLap = car.lastLap;
+        }
+        car.lapStart = now;
+
+        if (car.state == CarState::PitLaneIn) {
+            car.state = CarState::Stall;
+            car.stallTicks = (int)(m_config.pitStopSeconds * m_config.tickRate);
+            car.pitNext = false;
+        } else {
+            car.pitNext = uniform() < m_config.pitChance;
+        }
+        return;
+    }
+
+    if (car.state == CarState::Racing && car.pitNext && pct >= kPitEntryPct) {
+        car.state = CarState::PitLaneIn;
+    } else if (car.state == CarState::PitLaneOut && pct >= kPitExitPct && pct < kPitEntryPct) {
+        car.state = CarState::Racing;
+    }
+}
+
+void SyntheticTelemetry::sortByProgress() {
+    // Insertion sort: the order barely changes between ticks
+    for (size_t i = 1; i < m_order.size(); ++i) {
+        int carIdx = m_order[i];
+        size_t j = i;
+        while (j > 0 && m_cars[m_order[j - 1]].progress < m_cars[carIdx].progress) {
+            m_order[j] = m_order[j - 1];
+            --j;
+        }
+        m_order[j] = carIdx;
+    }
+}
+
+void SyntheticTelemetry::writeRow(char* row, double timestamp) {
+    bool* onPitRoad = reinterpret_cast<bool*>(row + m_offCarIdxOnPitRoad);
+    int* lap = reinterpret_cast<int*>(row + m_offCarIdxLap);
+    int* lapCompleted = reinterpret_cast<int*>(row + m_offCarIdxLapCompleted);
+    int* position = reinterpret_cast<int*>(row + m_offCarIdxPosition);
+    int* classPosition = reinterpret_cast<int*>(row + m_offCarIdxClassPosition);
+    float* lapDistPct = reinterpret_cast<float*>(row + m_offCarIdxLapDistPct);
+    float* f2Time = reinterpret_cast<float*>(row + m_offCarIdxF2Time);
+    float* lastLapTime = reinterpret_cast<float*>(row + m_offCarIdxLastLapTime);
+    float* bestLapTime = reinterpret_cast<float*>(row + m_offCarIdxBestLapTime);
+    int* trackSurface = reinterpret_cast<int*>(row + m_offCarIdxTrackSurface);
+
+    for (int i = m_activeCars; i < kMaxCars; ++i) {
+        onPitRoad[i] = false;
+        lap[i] = lapCompleted[i] = position[i] = classPosition[i] = 0;
+        lapDistPct[i] = -1.0f;
+        f2Time[i] = lastLapTime[i] = bestLapTime[i] = -1.0f;
+        trackSurface[i] = irsdk_NotInWorld;
+    }
+
+    const double leader = m_order.empty() ? 0.0 : m_cars[m_order[0]].progress;
+    int classCars[kClassCount] = {};
+    for (size_t p = 0; p < m_order.size(); ++p) {
+        const int i = m_order[p];
+        const Car& car = m_cars[i];
+        const double completed = std::floor(car.progress);
+
+        onPitRoad[i] = car.state != CarState::Racing;
+        lapCompleted[i] = (int)completed;
+        lap[i] = lapCompleted[i] + 1;
+        position[i] = (int)p + 1;
+        classPosition[i] = ++classCars[i % m_config.classes];
+        lapDistPct[i] = (float)(car.progress - completed);
+        f2Time[i] = (float)((leader - car.progress) * m_config.lapTime);
+        lastLapTime[i] = car.lastLap;
+        bestLapTime[i] = car.bestLap;
+        trackSurface[i] = car.state == CarState::Stall ? irsdk_InPitStall
+                        : car.state == CarState::Racing ? irsdk_OnTrack
+                        : irsdk_AproachingPits;
+    }
+
+    // The pace car sits in its stall, in the world but out of the race
+    if (const int pace = paceCarIdx(); pace >= 0) {
+        onPitRoad[pace] = true;
+        lap[pace] = lapCompleted[pace] = position[pace] = classPosition[pace] = 0;
+        lapDistPct[pace] = (float)kPitExitPct;
+        f2Time[pace] = lastLapTime[pace] = bestLapTime[pace] = -1.0f;
+        trackSurface[pace] = irsdk_InPitStall;
+    }
+
+    const double now = sessionTime();
+    *reinterpret_cast<double*>(row + m_offSessionTime) = now;
+    *reinterpret_cast<int*>(row + m_offSessionTick) = m_tick;
+    *reinterpret_cast<double*>(row + m_offSessionTimeRemain) = std::max(0.0, kSessionSeconds - now);
+    *reinterpret_cast<int*>(row + m_offPlayerCarIdx) = 0;
+    *reinterpret_cast<int*>(row + m_offIncidents) = 0;
+    *reinterpret_cast<int*>(row + m_offLap) = lap[0];
+    *reinterpret_cast<float*>(row + m_offLapLastLapTime) = m_cars[0].lastLap;
+    *reinterpret_cast<float*>(row + m_offLapBestLapTime) = m_cars[0].bestLap;
+    *reinterpret_cast<double*>(row + m_offWriterTimestamp) = timestamp;
+}
+
+void SyntheticTelemetry::buildSessionInfo() {
+    // Same sections and per-driver keys as the sim writes, so parsers are
+    // exercised (and benchmarked) against realistically sized strings
+    char line[2048];
+    snprintf(line, sizeof(line),
+             "---\n"
+             "WeekendInfo:\n"
+             " TrackName: synthetic_oval\n"
+             " TrackID: 999\n"
+             " TrackLength: 4.00 km\n"
+             " TrackDisplayName: Synthetic Oval\n"
+             " TrackCity: Nowhere\n"
+             " TrackCountry: Nowhere\n"
+             " TrackNumTurns: 4\n"
+             " TrackPitSpeedLimit: 72.00 kph\n"
+             " SeriesID: 1\n"
+             " SeasonID: 1\n"
+             " SessionID: 1\n"
+             " SubSessionID: 1\n"
+             " SeriesName: Synthetic Cup\n"
+             " Official: 1\n"
+             " NumCarClasses: %d\n"
+             " NumCarTypes: %d\n"
+             " WeekendOptions:\n"
+             "  NumStarters: %d\n"
+             "  StartingGrid: 2x2 inline pole on left\n"
+             "  QualifyScoring: best lap\n"
+             "  StandingStart: 0\n"
+             "SessionInfo:\n"
+             " Sessions:\n"
+             " - SessionNum: 0\n"
+             "   SessionLaps: unlimited\n"
+             "   SessionTime: %.4f sec\n"
+             "   SessionNumLapsToAvg: 0\n"
+             "   SessionType: Race\n"
+             "   SessionTrackRubberState: moderate usage\n"
+             "   SessionName: RACE\n"
+             "SplitTimeInfo:\n"
+             " Sectors:\n"
+             " - SectorNum: 0\n"
+             "   SectorStartPct: 0.000000\n"
+             " - SectorNum: 1\n"
+             "   SectorStartPct: 0.333333\n"
+             " - SectorNum: 2\n"
+             "   SectorStartPct: 0.666667\n"
+             "DriverInfo:\n"
+             " DriverCarIdx: 0\n"
+             " DriverUserID: 100000\n"
+             " PaceCarIdx: %d\n"
+             " DriverCarFuelMaxLtr: 120.000\n"
+             " DriverCarRedLine: 7500.000\n"
+             " DriverCarEstLapTime: %.4f\n"
+             " Drivers:\n",
+             m_config.classes, m_config.classes, m_config.cars, kSessionSeconds, paceCarIdx(), m_config.lapTime);
+    m_sessionInfo = line;
+
+    for (int i = 0; i < m_activeCars; ++i) {
+        const Driver& d = m_drivers[i];
+        const CarClass& cls = kClasses[i % m_config.classes];
+        snprintf(line, sizeof(line),
+                 " - CarIdx: %d\n"
+                 "   UserName: Driver %d\n"
+                 "   AbbrevName: Driver, %d\n"
+                 "   Initials: D%d\n"
+                 "   UserID: %d\n"
+                 "   TeamID: 0\n"
+                 "   TeamName: Driver %d\n"
+                 "   CarNumber: \"%d\"\n"
+                 "   CarNumberRaw: %d\n"
+                 "   CarPath: %s\n"
+                 "   CarClassID: %d\n"
+                 "   CarID: 132\n"
+                 "   CarIsPaceCar: 0\n"
+                 "   CarIsAI: 0\n"
+                 "   CarIsElectric: 0\n"
+                 "   CarScreenName: %s\n"
+                 "   CarScreenNameShort: %s\n"
+                 "   CarClassShortName: %s\n"
+                 "   CarClassRelSpeed: 0\n"
+                 "   CarClassLicenseLevel: 0\n"
+                 "   CarClassMaxFuelPct: 1.000 %%\n"
+                 "   CarClassWeightPenalty: 0.000 kg\n"
+                 "   CarClassPowerAdjust: 0.000 %%\n"
+                 "   CarClassDryTireSetLimit: 0 %%\n"
+                 "   CarClassColor: 0xffffff\n"
+                 "   CarClassEstLapTime: %.4f\n"
+                 "   IRating: %d\n"
+                 "   LicLevel: %d\n"
+                 "   LicSubLevel: %d\n"
+                 "   LicString: %c %d.%02d\n"
+                 "   LicColor: 0x0153db\n"
+                 "   IsSpectator: 0\n"
+                 "   CarDesignStr: 1,ffffff,000000,ff0000\n"
+                 "   HelmetDesignStr: 1,ffffff,000000,ff0000\n"
+                 "   SuitDesignStr: 1,ffffff,000000,ff0000\n"
+                 "   BodyType: 0\n"
+                 "   FaceType: 0\n"
+                 "   HelmetType: 0\n"
+                 "   CarNumberDesignStr: 0,0,ffffff,777777,000000\n"
+                 "   CarSponsor_1: 0\n"
+                 "   CarSponsor_2: 0\n"
+                 "   ClubName: %s\n"
+                 "   ClubID: %d\n"
+                 "   DivisionName: Division %d\n"
+                 "   DivisionID: %d\n"
+                 "   CurDriverIncidentCount: 0\n"
+                 "   TeamIncidentCount: 0\n",
+                 i, i, i, i, 100000 + i, i, i + 1, i + 1, cls.carPath, cls.id,
+                 cls.screenName, cls.screenName, cls.shortName, m_config.lapTime * m_cars[i].pace,
+                 d.iRating, d.licLevel, d.licSubLevel,
+                 "RDCBAP"[std::min(5, (d.licLevel - 1) / 4)], d.licSubLevel / 100, d.licSubLevel % 100,
+                 kClubs[d.club], d.club + 1, i % 10 + 1, i % 10);
+        m_sessionInfo += line;
+    }
+    if (const int pace = paceCarIdx(); pace >= 0) {
+        snprintf(line, sizeof(line),
+                 " - CarIdx: %d\n"
+                 "   UserName: Pace Car\n"
+                 "   AbbrevName: \n"
+                 "   Initials: \n"
+                 "   UserID: -1\n"
+                 "   TeamID: 0\n"
+                 "   TeamName: Pace Car\n"
+                 "   CarNumber: \"0\"\n"
+                 "   CarNumberRaw: 0\n"
+                 "   CarPath: safety pcporsche911cup\n"
+                 "   CarClassID: 11\n"
+                 "   CarID: 142\n"
+                 "   CarIsPaceCar: 1\n"
+                 "   CarIsAI: 0\n"
+                 "   CarIsElectric: 0\n"
+                 "   CarScreenName: safety pcporsche911cup\n"
+                 "   CarScreenNameShort: safety pcporsche911cup\n"
+                 "   CarClassShortName: \n"
+                 "   CarClassRelSpeed: 0\n"
+                 "   CarClassEstLapTime: %.4f\n"
+                 "   IRating: 0\n"
+                 "   LicLevel: 1\n"
+                 "   LicSubLevel: 1\n"
+                 "   LicString: R 0.01\n"
+                 "   LicColor: 0xffffff\n"
+                 "   IsSpectator: 0\n"
+                 "   ClubName: None\n"
+                 "   ClubID: 0\n"
+                 "   DivisionName: None\n"
+                 "   DivisionID: 0\n"
+                 "   CurDriverIncidentCount: 0\n"
+                 "   TeamIncidentCount: 0\n",
+                 pace, m_config.lapTime);
+        m_sessionInfo += line;
+    }
+    m_sessionInfo += "...\n";
+}
+
+} // namespace iracing
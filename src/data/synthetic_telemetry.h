@@ -0,0 +1,123 @@
+#ifndef SYNTHETIC_TELEMETRY_H
+#define SYNTHETIC_TELEMETRY_H
+
+#include "data/irsdk_layout.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace iracing {
+
+// Deterministic race generator on top of IRSDKLayout. Publishes the same
+// variables and DriverInfo YAML the overlay reads from the sim: a field of
+// up to 64 cars lapping at slightly different paces, pit stops, and
+// drivers joining over time (each join rewrites the session info and
+// bumps sessionInfoUpdate). The same Config always produces the same
+// rows, so load tests and benchmarks are comparable across commits.
+class SyntheticTelemetry {
+public:
+    static constexpr int kMaxCars = 64;
+
+    struct Config {
+        uint64_t seed = 1;
+        int tickRate = 60;
+        int cars = 20;              // final field size, player (CarIdx 0) included
+        int initialCars = 0;        // cars present at tick 0 (0 = whole field)
+        double joinInterval = 2.0;  // seconds between joins until the field is full
+        double lapTime = 90.0;      // reference lap in seconds
+        double pitChance = 0.05;    // chance per car and lap to pit at the next lap end
+        double pitStopSeconds = 25.0;
+        int classes = 1;            // car classes (1-5) by CarIdx % classes, GT3 first
+        bool paceCar = false;       // a pace car parked in its stall at CarIdx `cars` (field <= 63)
+    };
+
+    SyntheticTelemetry() : SyntheticTelemetry(Config()) {}
+    explicit SyntheticTelemetry(const Config& config);
+
+    // Size of the memory block to publish (shared memory or a buffer)
+    size_t size() const { return m_layout.totalSize(); }
+
+    // Writes header, var table, the initial session info and tick 0
+    void init(char* mem);
+
+    // Advances one tick and commits its row. timestamp fills the
+    // WriterTimestamp variable (latency measurement, 0 when unused).
+    // Returns true when the session info was rewritten by a join.
+    bool step(char* mem, double timestamp = 0.0);
+
+    const Config& config() const { return m_config; }
+    int tick() const { return m_tick; }
+    double sessionTime() const { return (double)m_tick / m_config.tickRate; }
+    int activeCars() const { return m_activeCars; }
+    int paceCarIdx() const { return m_config.paceCar ? m_config.cars : -1; }
+    const std::string& sessionInfo() const { return m_sessionInfo; }
+
+private:
+    enum class CarState { Racing, PitLaneIn, Stall, PitLaneOut };
+
+    struct Car {
+        double progress = 0.0;      // laps, fractional part is LapDistPct
+        double pace = 1.0;          // this car's lap time / reference
+        double lapStart = 0.0;
+        float lastLap = -1.0f;
+        float bestLap = -1.0f;
+        CarState state = CarState::Racing;
+        int stallTicks = 0;
+        bool pitNext = false;
+    };
+
+    struct Driver {
+        int iRating = 0;
+        int licLevel = 0;
+        int licSubLevel = 0;
+        int club = 0;
+    };
+
+    // xorshift64* seeded through splitmix64; std distributions are
+    // implementation-defined and would break cross-platform determinism
+    uint64_t nextRandom();
+    double uniform();           // [0, 1)
+    double gaussian();          // approx. N(0, 1), sum of 4 uniforms
+
+    void joinCar(int carIdx, double progress);
+    void advanceCar(Car& car, double dt);
+    void sortByProgress();
+    void writeRow(char* row, double timestamp);
+    void buildSessionInfo();
+
+    Config m_config;
+    IRSDKLayout m_layout;
+    uint64_t m_rngState = 0;
+
+    int m_tick = 0;
+    int m_activeCars = 0;
+    double m_nextJoinTime = 0.0;
+    Car m_cars[kMaxCars];
+    Driver m_drivers[kMaxCars];
+    std::vector<int> m_order;   // active carIdx, leader first
+    std::string m_sessionInfo;
+
+    int m_offSessionTime;
+    int m_offSessionTick;
+    int m_offSessionTimeRemain;
+    int m_offPlayerCarIdx;
+    int m_offIncidents;
+    int m_offLap;
+    int m_offLapLastLapTime;
+    int m_offLapBestLapTime;
+    int m_offCarIdxOnPitRoad;
+    int m_offCarIdxLap;
+    int m_offCarIdxLapCompleted;
+    int m_offCarIdxPosition;
+    int m_offCarIdxClassPosition;
+    int m_offCarIdxLapDistPct;
+    int m_offCarIdxF2Time;
+    int m_offCarIdxLastLapTime;
+    int m_offCarIdxBestLapTime;
+    int m_offCarIdxTrackSurface;
+    int m_offWriterTimestamp;
+};
+
+} // namespace iracing
+
+#endif // SYNTHETIC_TELEMETRY_H
@@ -0,0 +1,572 @@
+#include "data/telemetry_recorder.h"
+#include "data/irsdk_layout.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+namespace iracing {
+
+namespace {
+
+constexpr char kMagic[4] = { 'I', 'R', 'O', 'R' };
+constexpr size_t kFlushBytes = 256 * 1024;
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Numeric elements are predicted from the integer pattern of the last
+// three rows: linearly (prev + last step) while the element kept moving on
+// both of the last two rows, else as unchanged. Counters, clocks and the
+// float streams that advance every tick (LapDistPct, F2Time, SessionTime)
+// then leave small residuals; a value that changes once and holds
+// (a lap count, a lap time) costs one residual, not two.
+template<typename U>
+U load(const char* p) {
+    U value;
+    memcpy(&value, p, sizeof(U));
+    return value;
+}
+
+template<typename U>
+U predict(const char* p1, const char* p2, const char* p3) {
+    const U a = load<U>(p1), b = load<U>(p2), c = load<U>(p3);
+    const U step = a - b;
+    return (step != 0 && b != c) ? a + step : a;
+}
+
+// Signed difference of two patterns, zigzagged in their own width
+template<typename U>
+uint64_t encodeDiff(U cur, U pred) {
+    using S = typename std::make_signed<U>::type;
+    const S diff = static_cast<S>(static_cast<U>(cur - pred));
+    return static_cast<U>((static_cast<U>(diff) << 1) ^ static_cast<U>(diff >> (sizeof(U) * 8 - 1)));
+}
+
+template<typename U>
+U decodeDiff(uint64_t value, U pred) {
+    const U z = static_cast<U>(value);
+    return pred + static_cast<U>((z >> 1) ^ (static_cast<U>(0) - (z & 1)));
+}
+
+// Residual of one element against its prediction from the rows p1 (the
+// previous row), p2 and p3
+uint64_t residual(int type, const char* cur, const char* p1, const char* p2, const char* p3) {
+    switch (type) {
+        case irsdk_int:
+        case irsdk_float:
+            return encodeDiff(load<uint32_t>(cur), predict<uint32_t>(p1, p2, p3));
+        case irsdk_double:
+            return encodeDiff(load<uint64_t>(cur), predict<uint64_t>(p1, p2, p3));
+        case irsdk_bitField:
+            return load<uint32_t>(cur) ^ load<uint32_t>(p1);
+        default:
+            return static_cast<uint8_t>(*cur ^ *p1);
+    }
+}
+
+// Inverse of residual(): writes the element into out
+void applyResidual(int type, uint64_t value, char* out, const char* p1, const char* p2, const char* p3) {
+    switch (type) {
+        case irsdk_int:
+        case irsdk_float: {
+            const uint32_t v = decodeDiff(value, predict<uint32_t>(p1, p2, p3));
+            memcpy(out, &v, 4);
+            break;
+        }
+        case irsdk_double: {
+            const uint64_t v = decodeDiff(value, predict<uint64_t>(p1, p2, p3));
+            memcpy(out, &v, 8);
+            break;
+        }
+        case irsdk_bitField: {
+            const uint32_t v = load<uint32_t>(p1) ^ static_cast<uint32_t>(value);
+            memcpy(out, &v, 4);
+            break;
+        }
+        default:
+            *out = static_cast<char>(*p1 ^ static_cast<char>(value));
+            break;
+    }
+}
+
+// Entropy stage. Each element keeps an adaptive level, about twice the
+// recent mean of its residuals (halved every row, plus the new residual).
+// Active elements (level >= 2) are Rice coded with k = log2(level / 2);
+// quiet ones are coded as runs: at a quiet element with no run open the
+// count of quiet zeros up to the next nonzero quiet residual follows as
+// Elias gamma (count + 1), then that residual as gamma. Both sides update
+// the levels identically, so nothing but the bits is stored.
+constexpr int kRiceEscape = 24;  // unary quotients this long escape to gamma
+
+bool isQuiet(uint64_t level) {
+    return level < 2;
+}
+
+int riceParameter(uint64_t level) {
+    const uint64_t mean = level >> 1;
+    int k = 0;
+    while ((mean >> k) > 1) ++k;
+    return k;
+}
+
+uint64_t nextLevel(uint64_t level, uint64_t value) {
+    return level - (level >> 1) + std::min<uint64_t>(value, 1ull << 60);
+}
+
+int bitLength(uint64_t value) {
+    int n = 0;
+    while (value) {
+        ++n;
+        value >>= 1;
+    }
+    return n;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void put(uint64_t value, int bits) {
+        // MSB first, at most 32 bits at a time into the accumulator
+        while (bits > 32) {
+            bits -= 32;
+            put(value >> bits, 32);
+        }
+        if (bits <= 0) return;
+        m_acc = (m_acc << bits) | (value & ((1ull << bits) - 1));
+        m_count += bits;
+        while (m_count >= 8) {
+            m_count -= 8;
+            m_out.push_back(static_cast<uint8_t>(m_acc >> m_count));
+        }
+    }
+    void putOnes(int count) {
+        for (; count > 0; count -= 32) put(~0ull, std::min(count, 32));
+    }
+    // value >= 1
+    void putGamma(uint64_t value) {
+        const int length = bitLength(value);
+        put(0, length - 1);
+        put(value, length);
+    }
+    void putRice(uint64_t value, int k) {
+        const uint64_t quotient = value >> k;
+        if (quotient < kRiceEscape) {
+            putOnes(static_cast<int>(quotient));
+            put(0, 1);
+            put(value, k);
+        } else {
+            putOnes(kRiceEscape);
+            putGamma(value);
+        }
+    }
+    void flush() {
+        if (m_count > 0) put(0, 8 - m_count);
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_acc = 0;
+    int m_count = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    bool get(int bits, uint64_t& value) {
+        value = 0;
+        for (; bits > 0; --bits) {
+            if (m_pos >= m_size * 8) return false;
+            value = (value << 1) | ((m_data[m_pos >> 3] >> (7 - (m_pos & 7))) & 1);
+            ++m_pos;
+        }
+        return true;
+    }
+    bool getGamma(uint64_t& value) {
+        int zeros = 0;
+        uint64_t bit = 0;
+        for (;;) {
+            if (!get(1, bit)) return false;
+            if (bit) break;
+            if (++zeros >= 64) return false;
+        }
+        if (!get(zeros, value)) return false;
+        value |= 1ull << zeros;
+        return true;
+    }
+    bool getRice(int k, uint64_t& value) {
+        uint64_t quotient = 0, bit = 1;
+        while (quotient < kRiceEscape) {
+            if (!get(1, bit)) return false;
+            if (!bit) break;
+            ++quotient;
+        }
+        if (quotient == kRiceEscape) return getGamma(value);
+        if (!get(k, value)) return false;
+        value |= quotient << k;
+        return true;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// TelemetryRecorder
+// ---------------------------------------------------------------------------
+
+TelemetryRecorder::~TelemetryRecorder() {
+    stop();
+}
+
+bool TelemetryRecorder::start(const std::string& path, const irsdk_header* header, const char* base) {
+    stop();
+    if (!header || !base || header->bufLen <= 0) return false;
+
+    m_file = fopen(path.c_str(), "wb");
+    if (!m_file) {
+        std::cerr << "[Recorder] Cannot create " << path << std::endl;
+        return false;
+    }
+
+    m_bufLen = header->bufLen;
+    const auto* vars = reinterpret_cast<const irsdk_varHeader*>(base + header->varHeaderOffset);
+
+    m_elements.clear();
+    for (int i = 0; i < header->numVars; ++i) {
+        int size = IRSDKLayout::typeSize(vars[i].type);
+        if (size == 0 || vars[i].count <= 0 || vars[i].offset < 0 ||
+            vars[i].offset + size * vars[i].count > m_bufLen) {
+            continue;
+        }
+        for (int e = 0; e < vars[i].count; ++e) {
+            m_elements.push_back({ vars[i].offset + e * size, vars[i].type });
+        }
+    }
+    m_levels.assign(m_elements.size(), 0);
+    m_residuals.assign(m_elements.size(), 0);
+
+    uint32_t version = kVersion;
+    fwrite(kMagic, 1, sizeof(kMagic), m_file);
+    fwrite(&version, sizeof(version), 1, m_file);
+    fwrite(&header->tickRate, sizeof(int), 1, m_file);
+    fwrite(&header->bufLen, sizeof(int), 1, m_file);
+    fwrite(&header->numVars, sizeof(int), 1, m_file);
+    fwrite(vars, sizeof(irsdk_varHeader), header->numVars, m_file);
+
+    for (std::vector<char>& row : m_history) row.assign(m_bufLen, 0);
+    m_prevTick = 0;
+    m_writtenSessionUpdate = -1;
+    m_out.clear();
+    m_out.reserve(kFlushBytes + m_bufLen * 2);
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_pendingSession.clear();
+        m_pendingSessionUpdate = -1;
+    }
+    m_pushedSessionUpdate.store(-1);
+    m_rows.store(0);
+    m_writtenBytes.store(sizeof(kMagic) + sizeof(uint32_t) + 3 * sizeof(int) +
+                         sizeof(irsdk_varHeader) * header->numVars);
+
+    m_ring = std::make_unique<SnapshotRing>(kRingSlots, m_bufLen);
+    m_writerRunning.store(true);
+    m_writer = std::thread(&TelemetryRecorder::writerLoop, this);
+    m_active.store(true);
+
+    std::cout << "[Recorder] Recording to " << path << std::endl;
+    return true;
+}
+
+void TelemetryRecorder::stop() {
+    if (!m_active.load()) return;
+
+    // Wait out producers that saw m_active before it was cleared
+    m_active.store(false);
+    while (m_producers.load() > 0) std::this_thread::yield();
+
+    m_writerRunning.store(false);
+    m_writer.join();
+    fclose(m_file);
+    m_file = nullptr;
+
+    Stats s = stats();
+    double ratio = s.rawBytes > 0 ? 100.0 * s.writtenBytes / s.rawBytes : 0.0;
+    std::cout << "[Recorder] Stopped: rows=" << s.rows << " dropped=" << s.dropped
+              << " raw=" << s.rawBytes << " written=" << s.writtenBytes
+              << " (" << ratio << "%)" << std::endl;
+}
+
+void TelemetryRecorder::pushRow(const char* row, int size, int tickCount, int sessionInfoUpdate) {
+    m_producers.fetch_add(1);
+    if (m_active.load() && size == m_bufLen) {
+        if (SnapshotRing::Slot* slot = m_ring->acquireWrite()) {
+            memcpy(slot->data, row, size);
+            slot->size = size;
+            slot->tickCount = tickCount;
+            slot->sessionInfoUpdate = sessionInfoUpdate;
+            m_ring->commitWrite();
+        }
+    }
+    m_producers.fetch_sub(1);
+}
+
+void TelemetryRecorder::pushSessionInfo(const char* yaml, size_t length, int update) {
+    m_producers.fetch_add(1);
+    if (m_active.load() && yaml) {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_pendingSession.assign(yaml, length);
+        m_pendingSessionUpdate = update;
+        m_pushedSessionUpdate.store(update);
+    }
+    m_producers.fetch_sub(1);
+}
+
+TelemetryRecorder::Stats TelemetryRecorder::stats() const {
+    Stats s;
+    s.rows = m_rows.load();
+    s.dropped = m_ring ? m_ring->stats().dropped : 0;
+    s.rawBytes = s.rows * (uint64_t)m_bufLen;
+    s.writtenBytes = m_writtenBytes.load();
+    return s;
+}
+
+void TelemetryRecorder::writerLoop() {
+    for (;;) {
+        const SnapshotRing::Slot* slot = m_ring->peek();
+        if (!slot) {
+            // Producer is done once it cleared the flag; drain what is left
+            if (!m_writerRunning.load()) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        if (slot->sessionInfoUpdate != m_writtenSessionUpdate) writeSessionInfo();
+        writeRow(*slot);
+        m_ring->pop();
+    }
+    flushBuffer();
+}
+
+void TelemetryRecorder::writeSessionInfo() {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    if (m_pendingSessionUpdate == m_writtenSessionUpdate) return;
+
+    m_out.push_back('S');
+    putVarint(m_out, (uint64_t)(uint32_t)m_pendingSessionUpdate);
+    putVarint(m_out, m_pendingSession.size());
+    m_out.insert(m_out.end(), m_pendingSession.begin(), m_pendingSession.end());
+    m_writtenSessionUpdate = m_pendingSessionUpdate;
+}
+
+void TelemetryRecorder::writeRow(const SnapshotRing::Slot& slot) {
+    const char* cur = slot.data;
+    const char* p1 = m_history[0].data();
+    const char* p2 = m_history[1].data();
+    const char* p3 = m_history[2].data();
+
+    m_out.push_back('R');
+    putVarint(m_out, zigzag((int64_t)slot.tickCount - m_prevTick));
+
+    const size_t total = m_elements.size();
+    for (size_t e = 0; e < total; ++e) {
+        const int offset = m_elements[e].offset;
+        m_residuals[e] = residual(m_elements[e].type, cur + offset, p1 + offset, p2 + offset, p3 + offset);
+    }
+
+    m_payload.clear();
+    BitWriter bits(m_payload);
+    int64_t zeros = -1;  // quiet zeros left in the open run, -1 for none
+    for (size_t e = 0; e < total; ++e) {
+        const uint64_t value = m_residuals[e];
+        if (!isQuiet(m_levels[e])) {
+            bits.putRice(value, riceParameter(m_levels[e]));
+        } else {
+            if (zeros < 0) {
+                zeros = 0;
+                for (size_t n = e; n < total; ++n) {
+                    if (!isQuiet(m_levels[n])) continue;
+                    if (m_residuals[n] != 0) break;
+                    ++zeros;
+                }
+                bits.putGamma((uint64_t)zeros + 1);
+            }
+            if (zeros > 0) {
+                --zeros;
+            } else {
+                bits.putGamma(value);
+                zeros = -1;
+            }
+        }
+        m_levels[e] = nextLevel(m_levels[e], value);
+    }
+    bits.flush();
+    putVarint(m_out, m_payload.size());
+    m_out.insert(m_out.end(), m_payload.begin(), m_payload.end());
+
+    std::swap(m_history[2], m_history[1]);
+    std::swap(m_history[1], m_history[0]);
+    memcpy(m_history[0].data(), cur, m_bufLen);
+    m_prevTick = slot.tickCount;
+    m_rows.fetch_add(1);
+
+    if (m_out.size() >= kFlushBytes) flushBuffer();
+}
+
+void TelemetryRecorder::flushBuffer() {
+    if (m_out.empty()) return;
+    fwrite(m_out.data(), 1, m_out.size(), m_file);
+    m_writtenBytes.fetch_add(m_out.size());
+    m_out.clear();
+}
+
+// ---------------------------------------------------------------------------
+// RecordingReader
+// ---------------------------------------------------------------------------
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+
+    m_file = fopen(path.c_str(), "rb");
+    if (!m_file) return false;
+
+    char magic[4];
+    uint32_t version = 0;
+    int numVars = 0;
+    if (fread(magic, 1, 4, m_file) != 4 || memcmp(magic, kMagic, 4) != 0 ||
+        fread(&version, sizeof(version), 1, m_file) != 1 || version != TelemetryRecorder::kVersion ||
+        fread(&m_tickRate, sizeof(int), 1, m_file) != 1 ||
+        fread(&m_bufLen, sizeof(int), 1, m_file) != 1 ||
+        fread(&numVars, sizeof(int), 1, m_file) != 1 || numVars < 0 || m_bufLen <= 0) {
+        close();
+        return false;
+    }
+
+    m_vars.resize(numVars);
+    if (fread(m_vars.data(), sizeof(irsdk_varHeader), numVars, m_file) != (size_t)numVars) {
+        close();
+        return false;
+    }
+
+    // Same column filter as the writer, flattened to one entry per element
+    m_elements.clear();
+    for (const auto& var : m_vars) {
+        int size = IRSDKLayout::typeSize(var.type);
+        if (size == 0 || var.count <= 0 || var.offset < 0 || var.offset + size * var.count > m_bufLen) {
+            continue;
+        }
+        for (int i = 0; i < var.count; ++i) {
+            m_elements.push_back({ var.offset + i * size, var.type });
+        }
+    }
+
+    m_row.assign(m_bufLen, 0);
+    for (std::vector<char>& row : m_history) row.assign(m_bufLen, 0);
+    m_levels.assign(m_elements.size(), 0);
+    m_tick = 0;
+    return true;
+}
+
+void RecordingReader::close() {
+    if (m_file) fclose(m_file);
+    m_file = nullptr;
+}
+
+bool RecordingReader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(m_file);
+        if (c == EOF) return false;
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+bool RecordingReader::decodeRow() {
+    uint64_t value = 0;
+    if (!readVarint(value)) return false;
+    m_tick += static_cast<int>(unzigzag(value));
+
+    // Every element is rewritten: a zero residual means "as predicted",
+    // which is not necessarily the previous value
+    std::swap(m_history[2], m_history[1]);
+    std::swap(m_history[1], m_history[0]);
+    memcpy(m_history[0].data(), m_row.data(), m_bufLen);
+    const char* p1 = m_history[0].data();
+    const char* p2 = m_history[1].data();
+    const char* p3 = m_history[2].data();
+
+    uint64_t length = 0;
+    if (!readVarint(length) || length > m_elements.size() * 32 + 16) return false;  // 151 bits worst case
+    m_payload.resize(length);
+    if (length > 0 && fread(m_payload.data(), 1, length, m_file) != length) return false;
+
+    BitReader bits(m_payload.data(), m_payload.size());
+    int64_t zeros = -1;
+    for (size_t e = 0; e < m_elements.size(); ++e) {
+        if (!isQuiet(m_levels[e])) {
+            if (!bits.getRice(riceParameter(m_levels[e]), value)) return false;
+        } else {
+            if (zeros < 0) {
+                if (!bits.getGamma(value)) return false;
+                zeros = (int64_t)(value - 1);
+            }
+            if (zeros > 0) {
+                value = 0;
+                --zeros;
+            } else {
+                if (!bits.getGamma(value)) return false;
+                zeros = -1;
+            }
+        }
+        const int offset = m_elements[e].offset;
+        applyResidual(m_elements[e].type, value, m_row.data() + offset, p1 + offset, p2 + offset, p3 + offset);
+        m_levels[e] = nextLevel(m_levels[e], value);
+    }
+    return true;
+}
+
+RecordingReader::Record RecordingReader::next() {
+    if (!m_file) return Record::End;
+
+    int type = fgetc(m_file);
+    if (type == 'R') {
+        return decodeRow() ? Record::Row : Record::End;
+    }
+    if (type == 'S') {
+        uint64_t update = 0, length = 0;
+        if (!readVarint(update) || !readVarint(length)) return Record::End;
+        m_session.resize(length);
+        if (length > 0 && fread(&m_session[0], 1, length, m_file) != length) return Record::End;
+        m_sessionUpdate = static_cast<int>(update);
+        return Record::SessionInfo;
+    }
+    return Record::End;
+}
+
+} // namespace iracing
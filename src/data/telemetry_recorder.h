@@ -0,0 +1,149 @@
+#ifndef TELEMETRY_RECORDER_H
+#define TELEMETRY_RECORDER_H
+
+#include "irsdk/irsdk_defines.h"
+#include "data/snapshot_ring.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace iracing {
+
+// Compact on-disk capture of every varBuf row the overlay sees.
+//
+// File layout (little endian):
+//   "IROR" u32 version  i32 tickRate  i32 bufLen  i32 numVars
+//   irsdk_varHeader[numVars]
+//   records: 'S' varint update, varint length, YAML bytes
+//            'R' varint zigzag(tick delta), varint length, row bits
+// Every variable element is predicted from the previous rows (int, float
+// and double linearly on their bit patterns, bitfield/bool/char as
+// unchanged) and the zigzagged residuals are entropy coded with adaptive
+// per-element Rice parameters, elements that rarely change as zero runs,
+// so unchanged data costs almost nothing and smoothly moving data a few
+// bits per element.
+//
+// Rows are handed over from the ingest thread through a bounded lock-free
+// ring and encoded on the recorder's own thread; a full ring drops rows
+// instead of blocking the producer.
+class TelemetryRecorder {
+public:
+    static constexpr uint32_t kVersion = 2;
+    static constexpr int kRingSlots = 256;
+
+    struct Stats {
+        uint64_t rows = 0;          // rows written
+        uint64_t dropped = 0;       // rows lost to a full ring
+        uint64_t rawBytes = 0;      // rows * bufLen
+        uint64_t writtenBytes = 0;  // bytes in the file
+    };
+
+    TelemetryRecorder() = default;
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    // header/base describe the connection being recorded (var table)
+    bool start(const std::string& path, const irsdk_header* header, const char* base);
+    void stop();
+    bool isRecording() const { return m_active.load(); }
+
+    // Producer side, never blocks; safe to call while another thread stops
+    void pushRow(const char* row, int size, int tickCount, int sessionInfoUpdate);
+    void pushSessionInfo(const char* yaml, size_t length, int update);
+    bool needsSessionInfo(int update) const { return isRecording() && m_pushedSessionUpdate.load() != update; }
+
+    Stats stats() const;
+
+private:
+    struct Element {
+        int offset;
+        int type;
+    };
+
+    void writerLoop();
+    void writeRow(const SnapshotRing::Slot& slot);
+    void writeSessionInfo();
+    void flushBuffer();
+
+    std::vector<Element> m_elements;     // one per array element
+    std::vector<char> m_history[3];      // previous rows, newest first
+    std::vector<uint64_t> m_levels;      // entropy stage state per element
+    std::vector<uint64_t> m_residuals;
+    std::vector<uint8_t> m_payload;
+    std::vector<uint8_t> m_out;
+    int m_bufLen = 0;
+    int m_prevTick = 0;
+    int m_writtenSessionUpdate = -1;
+
+    FILE* m_file = nullptr;
+    std::unique_ptr<SnapshotRing> m_ring;
+    std::thread m_writer;
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_writerRunning{false};
+    std::atomic<int> m_producers{0};
+
+    // Session string handed over by the producer (rare, so a mutex is fine)
+    std::mutex m_sessionMutex;
+    std::string m_pendingSession;
+    int m_pendingSessionUpdate = -1;
+    std::atomic<int> m_pushedSessionUpdate{-1};
+
+    std::atomic<uint64_t> m_rows{0};
+    std::atomic<uint64_t> m_writtenBytes{0};
+};
+
+// Sequential decoder for files written by TelemetryRecorder
+class RecordingReader {
+public:
+    enum class Record { End, Row, SessionInfo };
+
+    ~RecordingReader();
+
+    bool open(const std::string& path);
+    void close();
+
+    const std::vector<irsdk_varHeader>& varHeaders() const { return m_vars; }
+    int tickRate() const { return m_tickRate; }
+    int bufLen() const { return m_bufLen; }
+
+    // Row: row()/tickCount() hold the decoded row.
+    // SessionInfo: sessionInfo()/sessionInfoUpdate() hold the YAML.
+    Record next();
+    const std::vector<char>& row() const { return m_row; }
+    int tickCount() const { return m_tick; }
+    const std::string& sessionInfo() const { return m_session; }
+    int sessionInfoUpdate() const { return m_sessionUpdate; }
+
+private:
+    struct Element {
+        int offset;
+        int type;
+    };
+
+    bool readVarint(uint64_t& value);
+    bool decodeRow();
+
+    FILE* m_file = nullptr;
+    std::vector<irsdk_varHeader> m_vars;
+    std::vector<Element> m_elements;
+    int m_tickRate = 0;
+    int m_bufLen = 0;
+    std::vector<char> m_row;
+    std::vector<char> m_history[3];
+    std::vector<uint64_t> m_levels;
+    std::vector<uint8_t> m_payload;
+    int m_tick = 0;
+    std::string m_session;
+    int m_sessionUpdate = 0;
+};
+
+} // namespace iracing
+
+#endif // TELEMETRY_RECORDER_H
@@ -0,0 +1,129 @@
+#include "data/telemetry_snapshot.h"
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <algorithm>
+
+namespace iracing {
+
+namespace {
+
+// The writer lives in another process, so force a real load every time.
+int loadTick(const irsdk_varBuf& buf) {
+    return *static_cast<const volatile int*>(&buf.tickCount);
+}
+
+} // namespace
+
+TelemetrySnapshot::~TelemetrySnapshot() {
+    release(m_front);
+    release(m_back);
+}
+
+char* TelemetrySnapshot::allocate(int& size) {
+    // Round up to whole cache lines so the tail is never shared
+    size_t bytes = (static_cast<size_t>(size) + kAlignment - 1) & ~(kAlignment - 1);
+    size = static_cast<int>(bytes);
+    return static_cast<char*>(::operator new(bytes, std::align_val_t(kAlignment)));
+}
+
+void TelemetrySnapshot::release(char* data) {
+    if (data) ::operator delete(data, std::align_val_t(kAlignment));
+}
+
+void TelemetrySnapshot::reserve(int size) {
+    if (size <= m_capacity) return;
+
+    // Row layout changed: the previous row no longer matches the new size
+    release(m_front);
+    release(m_back);
+    m_capacity = size;
+    m_front = allocate(m_capacity);
+    m_back = allocate(size);
+    m_tickCount = -1;
+    m_size = 0;
+}
+
+void TelemetrySnapshot::reset() {
+    m_external = nullptr;
+    m_size = 0;
+    m_tickCount = -1;
+    m_retries = 0;
+}
+
+int TelemetrySnapshot::latestBufIndex(const irsdk_header* header, int& tickCount) {
+    tickCount = -1;
+    if (!header) return -1;
+
+    int numBuf = std::min(header->numBuf, (int)IRSDK_MAX_BUFS);
+    int latest = -1;
+    for (int i = 0; i < numBuf; ++i) {
+        int tick = loadTick(header->varBuf[i]);
+        if (tick > tickCount) {
+            tickCount = tick;
+            latest = i;
+        }
+    }
+    return latest;
+}
+
+bool TelemetrySnapshot::copyLatestRow(const irsdk_header* header, const char* base,
+                                      char* dst, int& tickCount, int* retries) {
+    tickCount = -1;
+    if (!header || !base || !dst || header->bufLen <= 0) return false;
+
+    for (int attempt = 0; attempt < kMaxCaptureRetries; ++attempt) {
+        int tickBefore = -1;
+        int index = latestBufIndex(header, tickBefore);
+        if (index < 0) return false;
+
+        const irsdk_varBuf& buf = header->varBuf[index];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        memcpy(dst, base + buf.bufOffset, header->bufLen);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (loadTick(buf) == tickBefore) {
+            tickCount = tickBefore;
+            return true;
+        }
+        if (retries) ++*retries;
+    }
+    return false;
+}
+
+bool TelemetrySnapshot::capture(const irsdk_header* header, const char* base) {
+    if (!header || !base || header->bufLen <= 0) return false;
+
+    const int bufLen = header->bufLen;
+    reserve(bufLen);
+
+    int tickCount = -1;
+    if (!copyLatestRow(header, base, m_back, tickCount, &m_retries)) return false;
+
+    std::swap(m_front, m_back);
+    m_external = nullptr;
+    m_size = bufLen;
+    m_tickCount = tickCount;
+    return true;
+}
+
+void TelemetrySnapshot::assign(const char* row, int size, int tickCount) {
+    if (!row || size <= 0) return;
+
+    reserve(size);
+    memcpy(m_back, row, size);
+    std::swap(m_front, m_back);
+    m_external = nullptr;
+    m_size = size;
+    m_tickCount = tickCount;
+}
+
+void TelemetrySnapshot::reference(const char* row, int size, int tickCount) {
+    if (!row || size <= 0) return;
+
+    m_external = row;
+    m_size = size;
+    m_tickCount = tickCount;
+}
+
+} // namespace iracing
@@ -0,0 +1,67 @@
+#ifndef TELEMETRY_SNAPSHOT_H
+#define TELEMETRY_SNAPSHOT_H
+
+#include "irsdk/irsdk_defines.h"
+#include <cstddef>
+
+namespace iracing {
+
+// Private, cache-aligned copy of one varBuf row.
+//
+// capture() copies the newest row out of shared memory and validates it
+// seqlock-style against the row's tickCount, retrying when the writer
+// recycled the buffer mid-copy. Rows are copied into a back buffer and
+// swapped in only once validated, so the published row is immutable until
+// the next successful capture and every read for a tick sees one sample.
+class TelemetrySnapshot {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr int kMaxCaptureRetries = 8;
+
+    TelemetrySnapshot() = default;
+    ~TelemetrySnapshot();
+
+    TelemetrySnapshot(const TelemetrySnapshot&) = delete;
+    TelemetrySnapshot& operator=(const TelemetrySnapshot&) = delete;
+
+    // Copy the newest row. Returns false (keeping the previous row) when no
+    // consistent copy could be taken within kMaxCaptureRetries attempts.
+    bool capture(const irsdk_header* header, const char* base);
+    // Adopt a row that was already validated elsewhere (e.g. an ingest ring slot)
+    void assign(const char* row, int size, int tickCount);
+    // Point at an immutable row owned by someone else (zero-copy)
+    void reference(const char* row, int size, int tickCount);
+    void reset();
+
+    bool isValid() const { return m_tickCount >= 0; }
+    const char* data() const { return isValid() ? (m_external ? m_external : m_front) : nullptr; }
+    int size() const { return m_size; }
+    int tickCount() const { return m_tickCount; }
+    int retries() const { return m_retries; }
+
+    // Newest row index and tick in the header (tick is -1 if none)
+    static int latestBufIndex(const irsdk_header* header, int& tickCount);
+
+    // Validated copy of the newest row into dst (at least header->bufLen
+    // bytes). Returns false if every attempt was torn; retries are added
+    // to *retries when given.
+    static bool copyLatestRow(const irsdk_header* header, const char* base,
+                              char* dst, int& tickCount, int* retries = nullptr);
+
+private:
+    void reserve(int size);
+    static char* allocate(int& size);
+    static void release(char* data);
+
+    char* m_front = nullptr;
+    char* m_back = nullptr;
+    const char* m_external = nullptr;
+    int m_capacity = 0;
+    int m_size = 0;
+    int m_tickCount = -1;
+    int m_retries = 0;  // total retries since reset, for diagnostics
+};
+
+} // namespace iracing
+
+#endif // TELEMETRY_SNAPSHOT_H
@@ -0,0 +1,85 @@
+#ifndef TELEMETRY_TRANSPORT_H
+#define TELEMETRY_TRANSPORT_H
+
+#include "irsdk/irsdk_defines.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// POSIX equivalents of the Win32 object names in irsdk_defines.h
+#define IRSDK_POSIX_MEMMAPFILENAME     "/IRSDKMemMapFileName"
+#define IRSDK_POSIX_DATAVALIDEVENTNAME "/IRSDKDataValidEvent"
+
+namespace iracing {
+
+// Contents of the POSIX data-valid object. Writers bump sequence after each
+// tick and wake futex waiters on it; readers track the last value they saw.
+struct PosixDataValidSignal {
+    std::atomic<uint32_t> sequence;
+    uint32_t pad[15];  // (cache line)
+};
+
+// Source of an irsdk_header memory layout for IRSDKManager.
+//
+// The live sim is read through the platform shared-memory transport; other
+// implementations (in-process buffers, recorded files) expose the same
+// layout so the whole data path runs unchanged on top of them.
+class TelemetryTransport {
+public:
+    virtual ~TelemetryTransport() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    // Base of the mapped layout; irsdk_header offsets are relative to it
+    virtual const char* data() const = 0;
+    virtual size_t size() const = 0;
+    virtual const irsdk_header* header() const {
+        return reinterpret_cast<const irsdk_header*>(data());
+    }
+
+    // Block up to timeoutMS for the writer's data-valid signal. Returns
+    // false on timeout, or immediately when there is no signal, in which
+    // case callers fall back to polling tickCount.
+    virtual bool waitForDataValid(int timeoutMS) = 0;
+    virtual bool hasDataValidSignal() const = 0;
+
+    // True when published rows never change while open (file-backed
+    // sources). IRSDKManager then reads rows in place instead of copying.
+    virtual bool hasStableRows() const { return false; }
+
+    // Start of the row described by header()->varBuf[index]. Sources whose
+    // rows lie past the 2 GB reach of bufOffset (long .ibt files) override it.
+    virtual const char* row(int index) const {
+        return data() + header()->varBuf[index].bufOffset;
+    }
+};
+
+// Shared memory published by the sim (Win32 file mapping + event, or
+// POSIX shm_open + futex signal)
+std::unique_ptr<TelemetryTransport> createSharedMemoryTransport();
+
+// Caller-owned buffer holding an irsdk layout, for tools and benchmarks.
+// The buffer must outlive the transport.
+class MemoryTransport : public TelemetryTransport {
+public:
+    MemoryTransport(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+    bool open() override { return m_data != nullptr && m_size >= sizeof(irsdk_header); }
+    void close() override {}
+
+    const char* data() const override { return m_data; }
+    size_t size() const override { return m_size; }
+
+    bool waitForDataValid(int) override { return false; }
+    bool hasDataValidSignal() const override { return false; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+};
+
+} // namespace iracing
+
+#endif // TELEMETRY_TRANSPORT_H
@@ -1,6 +1,7 @@
 #define GLFW_INCLUDE_NONE
 #include "ui/overlay_window.h"
 #include <iostream>
+#include <cstring>
 
 int main(int argc, char* argv[]) {
     std::cout << "========================================" << std::endl;
@@ -19,6 +20,11 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // --ibt <file>: replay recorded telemetry instead of the live sim
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--ibt") == 0) overlay.openPlayback(argv[i + 1]);
+    }
+
     std::cout << "Overlay running!" << std::endl;
     std::cout << "Waiting for iRacing to start..." << std::endl;
     std::cout << std::endl;
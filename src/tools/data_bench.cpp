@@ -0,0 +1,1660 @@
+// data_bench - microbenchmarks for the telemetry data path, run over
+// synthetic irsdk layouts so results are comparable across machines/commits.
+//
+// Usage: data_bench [scenario...]   (no arguments runs every scenario)
+// Scenarios also check their results; a failed check prints FAIL and the
+// exit status is non-zero, so each scenario runs as a CTest test.
+
+#include "data/car_frame.h"
+#include "data/irsdk_layout.h"
+#include "data/gap_timer.h"
+#include "data/irating_calc.h"
+#include "data/irsdk_manager.h"
+#include "data/lap_delta.h"
+#include "data/lap_history.h"
+#include "data/pit_tracker.h"
+#include "data/race_order.h"
+#include "data/relative_calc.h"
+#include "data/sector_timer.h"
+#include "data/session_info_worker.h"
+#include "data/synthetic_telemetry.h"
+#include "data/telemetry_snapshot.h"
+#include "data/telemetry_transport.h"
+#include "utils/yaml_index.h"
+#include "utils/yaml_parser.h"
+#include "utils/yaml_scanner.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace iracing;
+
+// Allocation counting hook: every scalar, array and aligned operator new
+// in this binary goes through here (the nothrow forms forward to these),
+// so a scenario can assert on heap traffic. Each delete matches its new.
+static std::atomic<uint64_t> g_allocations{0};
+
+static void* countedAlloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+static void* countedAlignedAlloc(size_t size, std::align_val_t align) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t alignment = static_cast<size_t>(align);
+    size = (std::max<size_t>(size, 1) + alignment - 1) & ~(alignment - 1);
+#ifdef _WIN32
+    if (void* p = _aligned_malloc(size, alignment)) return p;
+#else
+    if (void* p = aligned_alloc(alignment, size)) return p;
+#endif
+    throw std::bad_alloc();
+}
+
+static void countedAlignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+void* operator new(size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void* p, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { countedAlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { countedAlignedFree(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile float g_sinkFloat = 0.0f;
+volatile int g_sinkInt = 0;
+
+template<typename Fn>
+double nsPerOp(long iterations, Fn&& fn) {
+    for (long i = 0; i < iterations / 10 + 1; ++i) fn();  // warm-up
+    auto start = Clock::now();
+    for (long i = 0; i < iterations; ++i) fn();
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / (double)iterations;
+}
+
+void report(const char* scenario, const char* label, double ns) {
+    printf("%-12s %-36s %12.1f ns\n", scenario, label, ns);
+}
+
+// One pass/fail condition of a scenario, printed when it fails
+bool check(const char* scenario, bool ok, const char* what) {
+    if (!ok) printf("%-12s FAIL %s\n", scenario, what);
+    return ok;
+}
+
+// In-memory irsdk block with its own manager attached
+struct SyntheticSdk {
+    IRSDKLayout layout;
+    std::vector<char> mem;
+    IRSDKManager sdk;
+
+    void publish() {
+        mem.assign(layout.finalize(), 0);
+        layout.init(mem.data());
+        IRSDKLayout::setConnected(mem.data(), true);
+        IRSDKLayout::commitRow(mem.data(), 0);
+        sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+        sdk.startup();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// varlookup: name resolution cost, linear strcmp scan vs hashed index vs handle
+// ---------------------------------------------------------------------------
+const char* kRelativeVars[] = {
+    "PlayerCarIdx", "Lap", "SessionTime", "SessionTimeRemain", "PlayerCarMyIncidentCount",
+    "LapLastLapTime", "LapBestLapTime", "CarIdxLap", "CarIdxLapCompleted", "CarIdxPosition",
+    "CarIdxLapDistPct", "CarIdxF2Time", "CarIdxLastLapTime", "CarIdxOnPitRoad", "CarIdxTrackSurface"
+};
+
+bool benchVarLookup() {
+    SyntheticSdk s;
+    char name[IRSDK_MAX_STRING];
+    for (int i = 0; i < 285; ++i) {
+        snprintf(name, sizeof(name), "Filler%03d", i);
+        s.layout.addVar(name, irsdk_float);
+    }
+    for (const char* var : kRelativeVars) {
+        s.layout.addVar(var, strncmp(var, "CarIdx", 6) == 0 ? irsdk_float : irsdk_int,
+                        strncmp(var, "CarIdx", 6) == 0 ? 64 : 1);
+    }
+    s.publish();
+
+    const auto* header = reinterpret_cast<const irsdk_header*>(s.mem.data());
+    const auto* vars = reinterpret_cast<const irsdk_varHeader*>(s.mem.data() + header->varHeaderOffset);
+    const int numVars = header->numVars;
+    const int lookups = (int)(sizeof(kRelativeVars) / sizeof(kRelativeVars[0]));
+
+    double linear = nsPerOp(20000, [&]() {
+        for (const char* var : kRelativeVars) {
+            for (int i = 0; i < numVars; ++i) {
+                if (strcmp(vars[i].name, var) == 0) { g_sinkInt = vars[i].offset; break; }
+            }
+        }
+    });
+    double hashed = nsPerOp(200000, [&]() {
+        for (const char* var : kRelativeVars) g_sinkInt = s.sdk.getVarHandle(var).offset;
+    });
+
+    std::vector<VarHandle> handles;
+    for (const char* var : kRelativeVars) handles.push_back(s.sdk.getVarHandle(var));
+    double byHandle = nsPerOp(2000000, [&]() {
+        int count = 0;
+        for (const auto& h : handles) {
+            g_sinkFloat = h.type == irsdk_float ? s.sdk.getFloatArray(h, count)[0] : (float)s.sdk.getInt(h);
+        }
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "linear strcmp (%d vars, %d reads)", numVars, lookups);
+    report("varlookup", label, linear);
+    report("varlookup", "hashed name index", hashed);
+    report("varlookup", "precomputed handle read", byHandle);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// synthetic: generator cost per tick, plus a checksum of the published rows
+// so a changed number flags a change in the generated race itself
+// ---------------------------------------------------------------------------
+bool benchSynthetic() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.tickRate = 360;
+    config.initialCars = 32;
+    config.joinInterval = 1.0;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    const auto* header = reinterpret_cast<const irsdk_header*>(mem.data());
+    uint64_t checksum = 1469598103934665603ull;
+    double ns = nsPerOp(36000, [&]() {
+        race.step(mem.data());
+        const char* row = mem.data() + header->varBuf[race.tick() % header->numBuf].bufOffset;
+        for (int i = 0; i < header->bufLen; ++i) checksum = (checksum ^ (uint8_t)row[i]) * 1099511628211ull;
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "step + checksum (%d cars, %d Hz)", race.activeCars(), config.tickRate);
+    report("synthetic", label, ns);
+    printf("%-12s checksum %016llx after %d ticks\n", "synthetic", (unsigned long long)checksum, race.tick());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// torn: TelemetrySnapshot::capture against a writer thread rewriting the
+// three rows of a synthetic header as fast as it can. Every word of a row
+// is stamped with its tick, so a capture that mixes two writes, or that
+// returns a row under another row's tickCount, is caught
+// ---------------------------------------------------------------------------
+bool benchTorn() {
+    constexpr int kWords = 1024;  // a 4 KB row, about a 64-car sim row
+    IRSDKLayout layout;
+    const int tickOffset = layout.addVar("Tick", irsdk_int);
+    const int wordsOffset = layout.addVar("Words", irsdk_int, kWords);
+    std::vector<char> mem(layout.finalize(), 0);
+    layout.init(mem.data());
+    IRSDKLayout::setConnected(mem.data(), true);
+
+    auto stamp = [&](int tick) {
+        char* row = IRSDKLayout::rowForTick(mem.data(), tick);
+        memcpy(row + tickOffset, &tick, sizeof(tick));
+        int* words = reinterpret_cast<int*>(row + wordsOffset);
+        for (int w = 0; w < kWords; ++w) *static_cast<volatile int*>(&words[w]) = tick * 31 + w;
+        IRSDKLayout::commitRow(mem.data(), tick);
+    };
+    stamp(1);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> written{1};
+    std::thread writer([&]() {
+        int tick = 1;
+        while (!stop.load(std::memory_order_relaxed)) stamp(++tick);
+        written.store(tick);
+    });
+
+    const auto* header = reinterpret_cast<const irsdk_header*>(mem.data());
+    TelemetrySnapshot snapshot;
+    const int kCaptures = 200000;
+    int captured = 0, failed = 0, mixed = 0;
+    auto start = Clock::now();
+    for (int n = 0; n < kCaptures; ++n) {
+        if (!snapshot.capture(header, mem.data())) {
+            ++failed;
+            continue;
+        }
+        ++captured;
+        const char* row = snapshot.data();
+        int tick = 0;
+        memcpy(&tick, row + tickOffset, sizeof(tick));
+        bool same = tick == snapshot.tickCount();
+        const int* words = reinterpret_cast<const int*>(row + wordsOffset);
+        for (int w = 0; w < kWords && same; ++w) same = words[w] == tick * 31 + w;
+        mixed += !same;
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kCaptures;
+
+    // Control: the same copies without the tickCount check, to show the
+    // writer does tear rows the check has to catch
+    std::vector<char> raw(header->bufLen);
+    int rawMixed = 0;
+    for (int n = 0; n < kCaptures; ++n) {
+        int tick = -1;
+        const int index = TelemetrySnapshot::latestBufIndex(header, tick);
+        memcpy(raw.data(), mem.data() + header->varBuf[index].bufOffset, header->bufLen);
+        memcpy(&tick, raw.data() + tickOffset, sizeof(tick));
+        const int* words = reinterpret_cast<const int*>(raw.data() + wordsOffset);
+        bool same = true;
+        for (int w = 0; w < kWords && same; ++w) same = words[w] == tick * 31 + w;
+        rawMixed += !same;
+    }
+    stop.store(true);
+    writer.join();
+
+    report("torn", "capture() under a full-speed writer", ns);
+    printf("%-12s %d captures, %d rows written, %d retries, %d gave up, %d mixed rows\n", "torn", captured,
+           written.load(), snapshot.retries(), failed, mixed);
+    printf("%-12s unchecked copies for comparison: %d of %d mixed\n", "torn", rawMixed, kCaptures);
+    bool ok = check("torn", mixed == 0, "a capture mixed two rows");
+    ok = check("torn", captured > kCaptures / 2, "most captures gave up") && ok;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// carframe: per-tick extraction of the CarIdx arrays into a CarFrame, against
+// fetching the same eight arrays by name each tick
+// ---------------------------------------------------------------------------
+bool benchCarFrame() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    sdk.update();
+
+    double byName = nsPerOp(200000, [&]() {
+        int count = 0;
+        g_sinkInt = sdk.getIntArray("CarIdxLap", count)[0];
+        g_sinkInt = sdk.getIntArray("CarIdxLapCompleted", count)[0];
+        g_sinkInt = sdk.getIntArray("CarIdxPosition", count)[0];
+        g_sinkInt = sdk.getIntArray("CarIdxTrackSurface", count)[0];
+        g_sinkFloat = sdk.getFloatArray("CarIdxLapDistPct", count)[0];
+        g_sinkFloat = sdk.getFloatArray("CarIdxF2Time", count)[0];
+        g_sinkFloat = sdk.getFloatArray("CarIdxLastLapTime", count)[0];
+        g_sinkInt = sdk.getBoolArray("CarIdxOnPitRoad", count)[0];
+    });
+
+    CarFrameReader reader;
+    CarFrame frame;
+    double read = nsPerOp(200000, [&]() {
+        reader.read(sdk, frame);
+        g_sinkFloat = frame.lapDistPct[0];
+    });
+
+    report("carframe", "8 CarIdx arrays by name (no copy)", byName);
+    report("carframe", "CarFrameReader::read (64 cars)", read);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// relative: full per-tick pipeline, generator -> IRSDKManager -> relative
+// ---------------------------------------------------------------------------
+bool benchRelative() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    RelativeCalculator relative(&sdk);
+    sdk.update();
+    relative.update();
+
+    double ns = nsPerOp(20000, [&]() {
+        race.step(mem.data());
+        sdk.update();
+        relative.update();
+    });
+    g_sinkInt = (int)relative.getAllDrivers().size();
+
+    // Same field split into five classes (per-class positions, SOF, gaps),
+    // one car fewer for a pace car in its stall
+    SyntheticTelemetry::Config multiConfig = config;
+    multiConfig.classes = 5;
+    multiConfig.cars = SyntheticTelemetry::kMaxCars - 1;
+    multiConfig.paceCar = true;
+    SyntheticTelemetry multiRace(multiConfig);
+    std::vector<char> multiMem(multiRace.size(), 0);
+    multiRace.init(multiMem.data());
+    IRSDKManager multiSdk;
+    multiSdk.setTransport(std::make_unique<MemoryTransport>(multiMem.data(), multiMem.size()));
+    multiSdk.startup();
+    RelativeCalculator multiRelative(&multiSdk);
+    double multiNs = nsPerOp(20000, [&]() {
+        multiRace.step(multiMem.data());
+        multiSdk.update();
+        multiRelative.update();
+    });
+
+    // What a widget frame adds on top: the relative window and its rows
+    double window = nsPerOp(200000, [&]() {
+        for (const Driver& d : relative.getRelative(4, 4)) g_sinkFloat = d.gapToPlayer;
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "step + update (%d cars)", race.activeCars());
+    report("relative", label, ns);
+    snprintf(label, sizeof(label), "same, %d classes + pace car", multiRelative.getClassCount());
+    report("relative", label, multiNs);
+
+    // The pace car is in the world but in no class, class field or SOF
+    std::vector<int> classRatings[RelativeCalculator::kMaxClasses], allRatings;
+    bool paceOk = false;
+    int classed = 0;
+    for (const Driver& d : multiRelative.getAllDrivers()) {
+        if (d.carIdx == multiRace.paceCarIdx()) {
+            paceOk = d.classIndex == Driver::kNoClass && d.classPosition == 0 && d.iRatingProjection == 0;
+            continue;
+        }
+        classRatings[d.classIndex].push_back(d.iRating);
+        allRatings.push_back(d.iRating);
+    }
+    bool sofOk = multiRelative.getSOF() == iRatingCalculator::calculateSOF(allRatings);
+    for (int c = 0; c < multiRelative.getClassCount(); ++c) {
+        classed += multiRelative.getClassSize(c);
+        sofOk = sofOk && multiRelative.getClassSOF(c) == iRatingCalculator::calculateSOF(classRatings[c]);
+    }
+    printf("%-12s pace car %s, %d of %d cars in classes, SOF and class SOFs %s\n", "relative",
+           paceOk ? "unclassed" : "CLASSED", classed, multiRelative.getAllDrivers().size(),
+           sofOk ? "match the racing cars" : "DIFFER");
+    bool ok = check("relative", paceOk, "pace car in a class or projected");
+    ok = check("relative", classed == multiConfig.cars, "racing cars missing from the classes") && ok;
+    ok = check("relative", sofOk, "SOF includes the pace car") && ok;
+    report("relative", "getRelative(4,4) + read rows", window);
+
+    // Track mode: nearest cars by circular distance, partial selection
+    // against sorting the whole field by the same distance
+    relative.setRelativeMode(RelativeMode::Track);
+    double track = nsPerOp(200000, [&]() {
+        for (const Driver& d : relative.getRelative(4, 4)) g_sinkFloat = d.trackGap;
+    });
+    DriverView all = relative.getAllDrivers();
+    std::vector<const Driver*> byDistance;
+    byDistance.reserve(CarFrame::kMaxCars);
+    double fullSort = nsPerOp(200000, [&]() {
+        byDistance.clear();
+        for (const Driver& d : all) byDistance.push_back(&d);
+        std::sort(byDistance.begin(), byDistance.end(),
+                  [](const Driver* a, const Driver* b) { return a->trackDistance > b->trackDistance; });
+        g_sinkFloat = byDistance[0]->trackGap;
+    });
+    report("relative", "getRelative(4,4) track mode", track);
+    report("relative", "same by full sort on distance", fullSort);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// order: race order per tick over recorded 64-car frames. The incremental
+// RaceOrder against the same insertion sort restarted from CarIdx order
+// every frame, and against std::stable_sort of full driver records (the
+// original per-frame sort, strings included)
+// ---------------------------------------------------------------------------
+bool benchOrder() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    CarFrameReader reader;
+
+    // 30 s at 60 Hz, recorded after four and a half minutes of racing:
+    // the field is spread out and far from CarIdx order, pits included
+    for (int i = 0; i < 16200; ++i) race.step(mem.data());
+    std::vector<CarFrame> frames(1800);
+    for (CarFrame& frame : frames) {
+        race.step(mem.data());
+        sdk.update();
+        reader.read(sdk, frame);
+    }
+
+    RaceOrder incremental;
+    long moves = 0;
+    double ns = nsPerOp((long)frames.size(), [&, n = (size_t)0]() mutable {
+        incremental.update(frames[n++ % frames.size()]);
+        moves += incremental.lastMoves();
+        g_sinkInt = incremental.cars()[0];
+    });
+
+    RaceOrder scratch;
+    long scratchMoves = 0;
+    double nsScratch = nsPerOp((long)frames.size(), [&, n = (size_t)0]() mutable {
+        scratch.reset();
+        scratch.update(frames[n++ % frames.size()]);
+        scratchMoves += scratch.lastMoves();
+        g_sinkInt = scratch.cars()[0];
+    });
+
+    struct Record {
+        int carIdx = 0;
+        int position = 0;
+        int lapCompleted = 0;
+        float lapDistPct = 0.0f;
+        float gaps[4] = {};
+        std::string carNumber, driverName, carClass, carBrand, countryCode;
+    };
+    std::vector<Record> records(CarFrame::kMaxCars);
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) {
+        records[i].carNumber = std::to_string(i + 1);
+        records[i].driverName = "Synthetic Driver Number " + std::to_string(i);
+        records[i].carClass = "GT3 Class";
+        records[i].carBrand = "porsche";
+        records[i].countryCode = "DE";
+    }
+    std::vector<Record> field;
+    double nsStable = nsPerOp((long)frames.size(), [&, n = (size_t)0]() mutable {
+        const CarFrame& f = frames[n++ % frames.size()];
+        field.clear();
+        for (int i = 0; i < f.carCount; ++i) {
+            if (!f.isInWorld(i)) continue;
+            Record& r = records[i];
+            r.carIdx = i;
+            r.position = f.position[i];
+            r.lapCompleted = f.lapCompleted[i];
+            r.lapDistPct = std::min(1.0f, std::max(0.0f, f.lapDistPct[i]));
+            field.push_back(r);
+        }
+        std::stable_sort(field.begin(), field.end(), [](const Record& a, const Record& b) {
+            if (a.lapCompleted != b.lapCompleted) return a.lapCompleted > b.lapCompleted;
+            if (std::abs(a.lapDistPct - b.lapDistPct) > 0.001f) return a.lapDistPct > b.lapDistPct;
+            int pa = (a.position > 0) ? a.position : 9999;
+            int pb = (b.position > 0) ? b.position : 9999;
+            return pa < pb;
+        });
+        g_sinkInt = field[0].carIdx;
+    });
+
+    // Warm-up runs count too; moves are reported per update
+    const double updates = (double)(frames.size() + frames.size() / 10 + 1);
+    char label[64];
+    snprintf(label, sizeof(label), "incremental (%.2f moves/frame)", moves / updates);
+    report("order", label, ns);
+    snprintf(label, sizeof(label), "from CarIdx order (%.1f moves/frame)", scratchMoves / updates);
+    report("order", label, nsScratch);
+    report("order", "stable_sort of driver records", nsStable);
+    return check("order", std::equal(incremental.cars(), incremental.cars() + incremental.count(), scratch.cars(),
+                                     scratch.cars() + scratch.count()),
+                 "incremental order differs from a sort from scratch");
+}
+
+// ---------------------------------------------------------------------------
+// gaps: GapTimer gaps to the leader against the generator's CarIdxF2Time
+// over ten minutes of a 64-car race (pits and lapped cars included), plus
+// the per-tick cost of recording crossings and of 64 gap lookups
+// ---------------------------------------------------------------------------
+bool benchGaps() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    CarFrameReader reader;
+    CarFrame frame;
+    VarHandle sessionTime;
+    GapTimer timer;
+
+    std::vector<double> errors;
+    long pairs = 0, timed = 0;
+    double updateNs = 0.0, lookupNs = 0.0;
+    const int kTicks = 600 * config.tickRate;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        race.step(mem.data());
+        sdk.update();
+        if (!sessionTime.isValid()) sessionTime = sdk.getVarHandle("SessionTime");
+        reader.read(sdk, frame);
+
+        auto start = Clock::now();
+        timer.update(frame, sdk.getDouble(sessionTime));
+        auto mid = Clock::now();
+        int leader = -1;
+        for (int i = 0; i < frame.carCount; ++i) {
+            if (frame.isInWorld(i) && frame.f2Time[i] == 0.0f) leader = i;
+        }
+        float gaps[CarFrame::kMaxCars];
+        bool have[CarFrame::kMaxCars] = {};
+        if (leader >= 0) {
+            for (int i = 0; i < frame.carCount; ++i) have[i] = timer.gap(i, leader, gaps[i]);
+        }
+        updateNs += std::chrono::duration<double, std::nano>(mid - start).count();
+        lookupNs += std::chrono::duration<double, std::nano>(Clock::now() - mid).count();
+
+        // The first two minutes let every car complete a timed lap
+        if (leader < 0 || tick < 120 * config.tickRate) continue;
+        for (int i = 0; i < frame.carCount; ++i) {
+            if (i == leader || !frame.isInWorld(i) || frame.f2Time[i] <= 0.0f) continue;
+            ++pairs;
+            if (!have[i]) continue;
+            ++timed;
+            errors.push_back(std::abs(gaps[i] - frame.f2Time[i]));
+        }
+    }
+
+    std::sort(errors.begin(), errors.end());
+    double mean = 0.0;
+    for (double e : errors) mean += e;
+    mean = errors.empty() ? 0.0 : mean / errors.size();
+    auto at = [&](double p) { return errors.empty() ? 0.0 : errors[(size_t)(p * (errors.size() - 1))]; };
+
+    report("gaps", "GapTimer::update (64 cars)", updateNs / kTicks);
+    report("gaps", "64 gap lookups", lookupNs / kTicks);
+    printf("%-12s vs F2Time: %.1f%% timed, |error| mean %.3f s p50 %.3f s p99 %.3f s max %.3f s\n", "gaps",
+           pairs ? 100.0 * timed / pairs : 0.0, mean, at(0.50), at(0.99), at(1.0));
+    bool ok = check("gaps", pairs > 0 && timed >= pairs * 99 / 100, "under 99% of the gaps timed");
+    ok = check("gaps", at(0.99) < 0.1, "p99 error 0.1 s or more") && ok;
+    ok = check("gaps", at(1.0) < 0.25, "max error 0.25 s or more") && ok;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// laps: LapHistory over an hour of a 64-car race (every ring wrapped),
+// per-tick update cost, stats and last-5-laps reads for the whole field
+// ---------------------------------------------------------------------------
+bool benchLaps() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    CarFrameReader reader;
+    CarFrame frame;
+    VarHandle sessionTime;
+    LapHistory history;
+
+    double updateNs = 0.0;
+    const int kTicks = 3600 * config.tickRate;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        race.step(mem.data());
+        sdk.update();
+        if (!sessionTime.isValid()) sessionTime = sdk.getVarHandle("SessionTime");
+        reader.read(sdk, frame);
+        const double now = sdk.getDouble(sessionTime);
+        auto start = Clock::now();
+        history.update(frame, now);
+        updateNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    double statsNs = nsPerOp(20000, [&]() {
+        float sum = 0.0f;
+        for (int i = 0; i < CarFrame::kMaxCars; ++i) sum += history.stats(i).stddev;
+        g_sinkFloat = sum;
+    });
+    LapHistory::Lap laps[5];
+    double recentNs = nsPerOp(20000, [&]() {
+        int sum = 0;
+        for (int i = 0; i < CarFrame::kMaxCars; ++i) sum += history.recentLaps(i, laps, 5);
+        g_sinkInt = sum;
+    });
+
+    int held = 0;
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) held += history.count(i);
+    report("laps", "LapHistory::update (64 cars)", updateNs / kTicks);
+    report("laps", "stats() for 64 cars", statsNs);
+    report("laps", "last 5 laps of 64 cars", recentNs);
+    printf("%-12s %d laps held after an hour (%d per car max, %zu bytes)\n", "laps", held, LapHistory::kLaps,
+           sizeof(LapHistory) + sizeof(LapHistory::Lap) * LapHistory::kLaps * CarFrame::kMaxCars);
+    return check("laps", held == LapHistory::kLaps * config.cars, "rings not full after an hour");
+}
+
+// ---------------------------------------------------------------------------
+// sectors: SectorTimer over half an hour of a 64-car race, with the
+// boundaries parsed from the session string's SplitTimeInfo. Checks each
+// lap's sector sum against CarIdxLastLapTime and sectors timed from every
+// 4th tick against those from every tick; plus the per-tick cost
+// ---------------------------------------------------------------------------
+bool benchSectors() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    sdk.update();
+    std::string yaml;
+    int update = 0;
+    sdk.copySessionInfo(yaml, update);
+    auto table = SessionTable::build(yaml, update);
+
+    SectorTimer timer, sparse;
+    timer.setSectors(table->sectorStarts.data(), (int)table->sectorStarts.size());
+    sparse.setSectors(table->sectorStarts.data(), (int)table->sectorStarts.size());
+    const int sectors = timer.sectorCount();
+
+    CarFrameReader reader;
+    CarFrame frame;
+    VarHandle sessionTime;
+    int lastSector[CarFrame::kMaxCars];
+    std::fill(lastSector, lastSector + CarFrame::kMaxCars, -1);
+    std::vector<double> lapErrors, sparseErrors;
+    double updateNs = 0.0;
+    const int kTicks = 1800 * config.tickRate;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        race.step(mem.data());
+        sdk.update();
+        if (!sessionTime.isValid()) sessionTime = sdk.getVarHandle("SessionTime");
+        reader.read(sdk, frame);
+        const double now = sdk.getDouble(sessionTime);
+
+        auto start = Clock::now();
+        timer.update(frame, now);
+        updateNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (tick % 4 == 0) sparse.update(frame, now);
+
+        for (int i = 0; i < frame.carCount; ++i) {
+            const int sector = timer.currentSector(i);
+            if (sector == lastSector[i]) continue;
+            const int done = lastSector[i];
+            lastSector[i] = sector;
+            if (done < 0 || sector != (done + 1) % sectors) continue;
+            if (tick % 4 == 0 && sparse.currentSector(i) == sector && timer.lastSector(i, done) > 0.0f &&
+                sparse.lastSector(i, done) > 0.0f) {
+                sparseErrors.push_back(std::abs(timer.lastSector(i, done) - sparse.lastSector(i, done)));
+            }
+            if (sector != 0 || frame.onPitRoad[i] || frame.lastLapTime[i] <= 0.0f) continue;
+            double sum = 0.0;
+            for (int s = 0; s < sectors && sum >= 0.0; ++s) {
+                const float t = timer.lastSector(i, s);
+                sum = t > 0.0f ? sum + t : -1.0;
+            }
+            if (sum > 0.0) lapErrors.push_back(std::abs(sum - frame.lastLapTime[i]));
+        }
+    }
+
+    auto summary = [](std::vector<double>& e, double& mean, double& p99) {
+        std::sort(e.begin(), e.end());
+        mean = 0.0;
+        for (double v : e) mean += v;
+        mean = e.empty() ? 0.0 : mean / e.size();
+        p99 = e.empty() ? 0.0 : e[(size_t)(0.99 * (e.size() - 1))];
+    };
+    double lapMean, lapP99, sparseMean, sparseP99;
+    summary(lapErrors, lapMean, lapP99);
+    summary(sparseErrors, sparseMean, sparseP99);
+
+    int bestCar = -1;
+    timer.sessionBestSector(0, &bestCar);
+    report("sectors", "SectorTimer::update (64 cars)", updateNs / kTicks);
+    printf("%-12s %d sectors; %zu laps: |sector sum - LastLapTime| mean %.4f s p99 %.4f s\n", "sectors",
+           sectors, lapErrors.size(), lapMean, lapP99);
+    printf("%-12s %zu sectors from every 4th tick: |error| mean %.4f s p99 %.4f s\n", "sectors",
+           sparseErrors.size(), sparseMean, sparseP99);
+    printf("%-12s session theoretical best %.3f s, car %d theoretical best %.3f s\n", "sectors",
+           timer.sessionTheoreticalBest(), bestCar, timer.theoreticalBest(bestCar));
+    bool ok = check("sectors", !lapErrors.empty() && lapP99 < 0.05, "sector sums off the lap time by 0.05 s");
+    ok = check("sectors", !sparseErrors.empty() && sparseP99 < 0.05, "sparse sectors off by 0.05 s") && ok;
+    ok = check("sectors", bestCar >= 0 && timer.sessionTheoreticalBest() > 0.0f, "no theoretical best") && ok;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// delta: LapDelta on one car over half an hour of racing. How far the
+// predicted lap time at half and nine tenths of a lap is from the lap the
+// car then completes, the per-tick cost and that of the ticks handing a
+// new reference to the saver, and a save/load round trip of the
+// reference file (a temporary file, removed afterwards)
+// ---------------------------------------------------------------------------
+bool benchDelta() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    config.pitChance = 0.0;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    CarFrameReader reader;
+    CarFrame frame;
+    VarHandle sessionTime;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "data_bench.lapref").string();
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    LapDelta delta;
+    delta.open(path);
+    const int car = 0;
+
+    std::vector<double> halfErrors, lateErrors;
+    float atHalf = -1.0f, atLate = -1.0f;
+    int lastCompleted = -1;
+    double updateNs = 0.0, newReferenceNs = 0.0;
+    int newReferences = 0;
+    const int kTicks = 1800 * config.tickRate;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        race.step(mem.data());
+        sdk.update();
+        if (!sessionTime.isValid()) sessionTime = sdk.getVarHandle("SessionTime");
+        reader.read(sdk, frame);
+        const double now = sdk.getDouble(sessionTime);
+
+        const float referenceBefore = delta.referenceLapTime();
+        auto start = Clock::now();
+        delta.update(frame, car, now);
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        updateNs += ns;
+        if (delta.referenceLapTime() != referenceBefore) {
+            newReferenceNs += ns;
+            ++newReferences;
+        }
+
+        float predicted;
+        const float pct = frame.lapDistPct[car];
+        if (atHalf < 0.0f && pct >= 0.5f && delta.predictedLapTime(predicted)) atHalf = predicted;
+        if (atLate < 0.0f && pct >= 0.9f && delta.predictedLapTime(predicted)) atLate = predicted;
+        if (frame.lapCompleted[car] != lastCompleted) {
+            if (lastCompleted >= 0 && frame.lastLapTime[car] > 0.0f && atHalf > 0.0f && atLate > 0.0f) {
+                halfErrors.push_back(std::abs(atHalf - frame.lastLapTime[car]));
+                lateErrors.push_back(std::abs(atLate - frame.lastLapTime[car]));
+            }
+            lastCompleted = frame.lapCompleted[car];
+            atHalf = atLate = -1.0f;
+        }
+    }
+
+    auto mean = [](const std::vector<double>& e) {
+        double sum = 0.0;
+        for (double v : e) sum += v;
+        return e.empty() ? 0.0 : sum / e.size();
+    };
+    report("delta", "LapDelta::update (1 car)", updateNs / kTicks);
+    report("delta", "update setting a new reference", newReferences ? newReferenceNs / newReferences : 0.0);
+    printf("%-12s %zu laps, reference %.3f s: |predicted - lap| mean %.3f s at 50%%, %.3f s at 90%%\n", "delta",
+           lateErrors.size(), delta.referenceLapTime(), mean(halfErrors), mean(lateErrors));
+
+    delta.flush();
+    LapDelta loaded;
+    bool same = loaded.open(path) && loaded.referenceLapTime() == delta.referenceLapTime();
+    std::streambuf* log = std::cout.rdbuf(nullptr);  // open() logs every load
+    double loadNs = nsPerOp(200, [&]() { g_sinkInt = loaded.open(path); });
+    std::cout.rdbuf(log);
+    std::cout.clear();
+    report("delta", "open() of a saved reference", loadNs);
+    printf("%-12s reference file %ju bytes, reloaded %s\n", "delta",
+           (uintmax_t)std::filesystem::file_size(path, ec), same ? "identical" : "DIFFERENT");
+    std::filesystem::remove(path, ec);
+    bool ok = check("delta", !lateErrors.empty() && mean(lateErrors) < 0.1, "prediction at 90% off by 0.1 s");
+    ok = check("delta", same, "saved reference reloaded different") && ok;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// pits: PitTracker over an hour of a 64-car race with frequent stops. The
+// track model against the generator's pit lane (a tenth of a lap at half
+// speed, so a tenth of a lap lost, plus the stop), the per-tick cost, and
+// through RelativeCalculator the rejoin position projected as the player
+// enters pit road against the position they hold once back up to speed
+// ---------------------------------------------------------------------------
+bool benchPits() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    config.pitChance = 0.2;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    RelativeCalculator relative(&sdk);
+    relative.setSessionInfoAsync(false);
+    CarFrameReader reader;
+    CarFrame frame;
+    VarHandle sessionTime;
+    LapHistory history;
+    PitTracker tracker;
+
+    PitRejoin projected, entered;
+    bool wasInPit = false;
+    int exitLap = -1;
+    std::vector<int> rejoinErrors;
+    uint64_t inLaneAtEntry = 0, pittedSince = 0;  // other cars, CarIdx masks
+    int pittedDuring = 0;
+    double updateNs = 0.0;
+    const int kTicks = 3600 * config.tickRate;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        race.step(mem.data());
+        sdk.update();
+        if (!sessionTime.isValid()) sessionTime = sdk.getVarHandle("SessionTime");
+        reader.read(sdk, frame);
+        const double now = sdk.getDouble(sessionTime);
+        history.update(frame, now);
+        auto start = Clock::now();
+        tracker.update(frame, now, history);
+        updateNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        relative.update();
+        const int player = relative.getPlayerCarIdx();
+        if (player < 0) continue;
+        const PitTracker& pits = relative.getPitTracker();
+        const bool inPit = pits.inPitLane(player);
+        uint64_t inLane = 0;
+        for (int i = 0; i < frame.carCount; ++i) {
+            if (i != player && pits.inPitLane(i)) inLane |= 1ull << i;
+        }
+        if (inPit && !wasInPit) {
+            entered = projected;  // as it stood on the last tick before pit road
+            exitLap = -1;
+            inLaneAtEntry = inLane;
+            pittedSince = 0;
+        }
+        pittedSince |= inLane & ~inLaneAtEntry;
+        if (!inPit) projected = relative.getPitRejoin();
+        if (!inPit && wasInPit && entered.valid) exitLap = frame.lapCompleted[player];
+        // Half a lap after the exit the cars that pitted meanwhile are back
+        // to speed too
+        if (exitLap >= 0 && frame.lapCompleted[player] == exitLap && frame.lapDistPct[player] >= 0.5f) {
+            rejoinErrors.push_back(entered.position - frame.position[player]);
+            for (uint64_t m = pittedSince; m; m &= m - 1) ++pittedDuring;
+            exitLap = -1;
+        }
+        wasInPit = inPit;
+    }
+
+    int stops = 0;
+    for (int i = 0; i < CarFrame::kMaxCars; ++i) stops += tracker.stopCount(i);
+    const float expectedLane = 0.1f * (float)config.lapTime;
+    report("pits", "PitTracker::update (64 cars)", updateNs / kTicks);
+    printf("%-12s %d stops, %d in the model: lane loss %.2f s (generator ~%.1f s), stop %.2f s (%.1f s)\n", "pits",
+           stops, tracker.modelSamples(), tracker.modelLaneLoss(), expectedLane, tracker.modelStopSeconds(),
+           config.pitStopSeconds);
+
+    // Positive when the player came out ahead of the projection. Each car
+    // within the pit loss behind is a coin toss on the stop chance, so a
+    // stop's error spreads by about two positions and the mean of a few
+    // stops by well under one: a mean outside kMaxRejoinBias is a
+    // systematic error in the projection
+    constexpr double kMaxRejoinBias = 1.5;
+    double sum = 0.0, sumAbs = 0.0;
+    for (int e : rejoinErrors) {
+        sum += e;
+        sumAbs += std::abs(e);
+    }
+    const double n = rejoinErrors.empty() ? 1.0 : (double)rejoinErrors.size();
+    const double bias = sum / n;
+    const PitTracker& model = relative.getPitTracker();
+    printf("%-12s relative model %.2f s pit loss, stop chance %.2f per lap\n", "pits", model.modelPitLoss(),
+           model.stopChance());
+    printf("%-12s %zu player stops: projected - actual position mean %+.1f (bound %.1f), |mean| %.1f\n", "pits",
+           rejoinErrors.size(), bias, kMaxRejoinBias, sumAbs / n);
+    printf("%-12s other cars entering pit road during a player stop: %.1f on average\n", "pits", pittedDuring / n);
+    bool ok = check("pits", std::abs(tracker.modelLaneLoss() - expectedLane) < 1.0f, "lane loss off by 1 s");
+    ok = check("pits", std::abs(tracker.modelStopSeconds() - (float)config.pitStopSeconds) < 1.0f,
+               "stop time off by 1 s") && ok;
+    ok = check("pits", !rejoinErrors.empty(), "no player stop to check the rejoin against") && ok;
+    ok = check("pits", std::abs(bias) <= kMaxRejoinBias, "rejoin projection biased beyond the bound") && ok;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// irating: the SOF / pairwise expected-score model against race results,
+// then the cost of binding a 64-driver field, of the per-tick projections
+// from it, and of the direct O(n²) evaluation with an exp() per pair every
+// tick.
+//
+// Two kinds of results. The built-in rows are the model evaluated in
+// double precision: they pin the float engine to the formula, not the
+// formula to iRacing. Published results (official races' results pages)
+// are read on every run from src/tools/irating_results.txt, and from the
+// file named by IRATING_RESULTS too, one race per line, finishing order:
+//   <source> ; <SOF> ; <iRating>:<change> <iRating>:<change> ...
+// '#' starts a comment. iRacing rounds each change and counts drivers who
+// did not start, so a published race passes within +-1 point.
+// ---------------------------------------------------------------------------
+struct RaceResult {
+    std::string source;
+    std::vector<int> field;       // finishing order
+    int sof = 0;
+    std::vector<int> deltas;
+};
+
+// False when the file cannot be read
+bool loadRaceResults(const char* path, std::vector<RaceResult>& races) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        const size_t a = line.find(';');
+        const size_t b = a == std::string::npos ? a : line.find(';', a + 1);
+        if (b == std::string::npos) continue;
+        RaceResult race;
+        race.source = line.substr(0, a);
+        while (!race.source.empty() && isspace((unsigned char)race.source.back())) race.source.pop_back();
+        race.sof = atoi(line.c_str() + a + 1);
+        std::istringstream drivers(line.substr(b + 1));
+        std::string pair;
+        while (drivers >> pair) {
+            const size_t colon = pair.find(':');
+            if (colon == std::string::npos) continue;
+            race.field.push_back(atoi(pair.c_str()));
+            race.deltas.push_back(atoi(pair.c_str() + colon + 1));
+        }
+        if (race.field.size() >= 2) races.push_back(std::move(race));
+    }
+    return true;
+}
+
+// Checks of one race, failures printed; tolerance in points
+int checkRace(iRatingField& field, const RaceResult& race, int tolerance, int& checks) {
+    const int n = (int)race.field.size();
+    int failures = 0;
+    field.setField(race.field.data(), n);
+    const int sofs[2] = { iRatingCalculator::calculateSOF(race.field), field.sof() };
+    for (int sof : sofs) {
+        ++checks;
+        if (std::abs(sof - race.sof) > tolerance) {
+            ++failures;
+            printf("%-12s FAIL %s: SOF %d, expected %d\n", "irating", race.source.c_str(), sof, race.sof);
+        }
+    }
+    for (int p = 0; p < n; ++p) {
+        ++checks;
+        const int delta = field.delta(p, p + 1);
+        if (std::abs(delta - race.deltas[p]) > tolerance) {
+            ++failures;
+            printf("%-12s FAIL %s: P%d %+d, expected %+d\n", "irating", race.source.c_str(), p + 1, delta,
+                   race.deltas[p]);
+        }
+    }
+    return failures;
+}
+
+bool benchIRating() {
+    const char* kModel = "double-precision model";
+    const RaceResult model[] = {
+        { kModel, { 1500, 1500 }, 1500, { 50, -49 } },
+        { kModel, { 1000, 3000 }, 1790, { 83, -82 } },
+        { kModel, { 3000, 1000 }, 1790, { 17, -16 } },
+        { kModel, { 2150, 3400, 1780, 5120, 1350, 2600, 1995, 4200, 1600, 2875 }, 2458,
+          { 102, 47, 74, -25, 50, -11, -12, -89, -38, -98 } },
+    };
+    int checks = 0, failures = 0;
+    iRatingField field;
+    for (const RaceResult& race : model) failures += checkRace(field, race, 0, checks);
+    // A field all rated the same is what calculateDelta() assumes
+    ++checks;
+    if (iRatingCalculator::calculateDelta(1500, 1500, 1, 2) != 50) ++failures;
+    printf("%-12s model: %d/%d checks ok\n", "irating", checks - failures, checks);
+
+#ifdef IRATING_RESULTS_FIXTURE
+    const char* fixture = IRATING_RESULTS_FIXTURE;
+#else
+    const char* fixture = "src/tools/irating_results.txt";
+#endif
+    const char* paths[2] = { fixture, getenv("IRATING_RESULTS") };
+    for (const char* path : paths) {
+        if (!path) continue;
+        std::vector<RaceResult> races;
+        if (!loadRaceResults(path, races)) {
+            ++failures;
+            printf("%-12s FAIL cannot read %s\n", "irating", path);
+            continue;
+        }
+        int raceChecks = 0, raceFailures = 0;
+        for (const RaceResult& race : races) raceFailures += checkRace(field, race, 1, raceChecks);
+        failures += raceFailures;
+        printf("%-12s published results: %zu races from %s, %d/%d checks within 1 point\n", "irating",
+               races.size(), path, raceChecks - raceFailures, raceChecks);
+    }
+
+    int ratings[iRatingField::kMaxDrivers];
+    uint32_t seed = 12345;
+    for (int& r : ratings) {
+        seed = seed * 1664525u + 1013904223u;
+        r = 800 + (int)(seed >> 16) % 5000;
+    }
+    const int kDrivers = iRatingField::kMaxDrivers;
+    double bindNs = nsPerOp(20000, [&]() { field.setField(ratings, kDrivers); g_sinkInt = field.sof(); });
+    int shift = 0;
+    double tickNs = nsPerOp(200000, [&]() {
+        int sum = 0;
+        for (int p = 0; p < kDrivers; ++p) sum += field.delta(p, (p + shift) % kDrivers + 1);
+        g_sinkInt = sum;
+        ++shift;
+    });
+    double directNs = nsPerOp(2000, [&]() {
+        const double base = 1600.0 / std::log(2.0);
+        int sum = 0;
+        for (int a = 0; a < kDrivers; ++a) {
+            double expected = -0.5;
+            for (int b = 0; b < kDrivers; ++b) {
+                const double ea = std::exp(-ratings[a] / base), eb = std::exp(-ratings[b] / base);
+                expected += (1 - ea) * eb / ((1 - eb) * ea + (1 - ea) * eb);
+            }
+            const int pos = (a + shift) % kDrivers + 1;
+            sum += (int)((kDrivers - pos - expected - (kDrivers / 2.0 - pos) / 100.0) * 200.0 / kDrivers);
+        }
+        g_sinkInt = sum;
+        ++shift;
+    });
+
+    report("irating", "setField (64 drivers)", bindNs);
+    report("irating", "64 projections per tick", tickNs);
+    report("irating", "same, direct O(n^2) with exp()", directNs);
+    return failures == 0;
+}
+
+// ---------------------------------------------------------------------------
+// alloc: heap allocations per frame of IRSDKManager::update +
+// RelativeCalculator::update and what the relative widget reads from it,
+// in steady state (64 cars in 5 classes, no session changes)
+// ---------------------------------------------------------------------------
+bool benchAlloc() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars;
+    config.pitChance = 0.0;
+    config.classes = 5;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    // Real names rarely fit std::string's small buffer; lengthen the
+    // generator's "Driver N" so copies of them would have to allocate
+    std::string yaml = race.sessionInfo();
+    const std::string from = "UserName: Driver ", to = "UserName: Synthetic Driver Number ";
+    for (size_t at = yaml.find(from); at != std::string::npos; at = yaml.find(from, at + to.size())) {
+        yaml.replace(at, from.size(), to);
+    }
+    IRSDKLayout::writeSessionInfo(mem.data(), yaml.c_str(), yaml.size());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    RelativeCalculator relative(&sdk);
+    relative.setSessionInfoAsync(false);
+
+    std::string series, lapInfo;
+    auto frame = [&]() {
+        race.step(mem.data());
+        sdk.update();
+        relative.update();
+        for (const Driver& d : relative.getRelative(4, 4)) g_sinkInt = d.relativePosition;
+        series = relative.getSeriesName();
+        lapInfo = relative.getLapInfo();
+    };
+    for (int i = 0; i < 600; ++i) frame();  // warm-up: session info, buffers
+
+    const int kFrames = 6000;
+    uint64_t before = g_allocations.load();
+    for (int i = 0; i < kFrames; ++i) frame();
+    uint64_t allocations = g_allocations.load() - before;
+
+    printf("%-12s %llu allocations over %d frames (%.2f per frame, %d drivers, %d classes)\n", "alloc",
+           (unsigned long long)allocations, kFrames, (double)allocations / kFrames,
+           (int)relative.getAllDrivers().size(), relative.getClassCount());
+    return check("alloc", allocations == 0, "the steady-state frame allocates");
+}
+
+// ---------------------------------------------------------------------------
+// dirty: 144 Hz render loop over 60 Hz telemetry, recomputing only on a new
+// data version vs recomputing every frame (invalidate() = old behaviour).
+// Only RelativeCalculator::update() is timed; the generator step and the
+// snapshot copy in IRSDKManager::update() run outside the clock
+// ---------------------------------------------------------------------------
+bool benchDirty() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    IRSDKManager sdk;
+    sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+    sdk.startup();
+    RelativeCalculator relative(&sdk);
+    sdk.update();
+    relative.update();
+
+    const int kRenderHz = 144;
+    const int kFrames = 28800;
+    long frame = 0;
+    auto renderFrames = [&](bool always) {
+        double ns = 0.0;
+        for (int n = 0; n < kFrames; ++n) {
+            // Telemetry advances on the frames where a 60 Hz tick became due
+            if ((frame + 1) * config.tickRate / kRenderHz != frame * config.tickRate / kRenderHz) {
+                race.step(mem.data());
+            }
+            ++frame;
+            sdk.update();
+            auto start = Clock::now();
+            if (always) relative.invalidate();
+            relative.update();
+            ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+        return ns / kFrames;
+    };
+
+    renderFrames(false);  // warm-up
+    double always = renderFrames(true);
+    uint64_t skippedBefore = relative.getUpdatesSkipped();
+    uint64_t computedBefore = relative.getUpdatesComputed();
+    double dirty = renderFrames(false);
+
+    report("dirty", "update(), recompute every frame", always);
+    report("dirty", "update(), recompute on new data", dirty);
+    const uint64_t computed = relative.getUpdatesComputed() - computedBefore;
+    const uint64_t skipped = relative.getUpdatesSkipped() - skippedBefore;
+    printf("%-12s computed=%llu skipped=%llu\n", "dirty", (unsigned long long)computed, (unsigned long long)skipped);
+    return check("dirty", computed > 0 && skipped > computed, "frames without new data recomputed");
+}
+
+// ---------------------------------------------------------------------------
+// joinstorm: per-frame update() latency while cars keep joining (a new
+// session info string every few ticks), parsing session info inside
+// update() vs on the worker thread. Frames are paced like the render loop,
+// which idles between frames: back to back on a single core the worker's
+// parse would land inside the timed update() it was meant to leave.
+// ---------------------------------------------------------------------------
+bool benchJoinStorm() {
+    const double kBucketsUs[] = { 25, 50, 100, 250, 500, 1000 };
+    const int kBuckets = sizeof(kBucketsUs) / sizeof(kBucketsUs[0]);
+
+    auto run = [&](bool async) -> double {
+        std::vector<double> frameUs;
+        int joins = 0;
+        for (uint64_t seed = 1; seed <= 10; ++seed) {
+            SyntheticTelemetry::Config config;
+            config.seed = seed;
+            config.cars = SyntheticTelemetry::kMaxCars;
+            config.initialCars = 4;
+            config.joinInterval = 0.05;
+            SyntheticTelemetry race(config);
+            std::vector<char> mem(race.size(), 0);
+            race.init(mem.data());
+
+            IRSDKManager sdk;
+            sdk.setTransport(std::make_unique<MemoryTransport>(mem.data(), mem.size()));
+            sdk.startup();
+            RelativeCalculator relative(&sdk);
+            relative.setSessionInfoAsync(async);
+
+            for (int tick = 0; tick < 300; ++tick) {
+                if (race.step(mem.data())) ++joins;
+                sdk.update();
+                auto start = Clock::now();
+                relative.update();
+                frameUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                std::this_thread::sleep_for(std::chrono::microseconds(300));
+            }
+        }
+
+        int counts[kBuckets + 1] = {};
+        for (double us : frameUs) {
+            int b = 0;
+            while (b < kBuckets && us >= kBucketsUs[b]) ++b;
+            ++counts[b];
+        }
+        std::sort(frameUs.begin(), frameUs.end());
+        const char* mode = async ? "async" : "sync";
+        printf("%-12s %-6s frames=%zu joins=%d p50=%.1fus p99=%.1fus max=%.1fus\n", "joinstorm", mode,
+               frameUs.size(), joins, frameUs[frameUs.size() / 2], frameUs[frameUs.size() * 99 / 100],
+               frameUs.back());
+        printf("%-12s %-6s", "joinstorm", mode);
+        for (int b = 0; b <= kBuckets; ++b) {
+            if (b < kBuckets) printf(" <%g:%d", kBucketsUs[b], counts[b]);
+            else printf(" >=%g:%d", kBucketsUs[kBuckets - 1], counts[b]);
+        }
+        printf("\n");
+        return frameUs[frameUs.size() * 99 / 100];
+    };
+
+    const double syncP99 = run(false);
+    const double asyncP99 = run(true);
+    return check("joinstorm", asyncP99 < syncP99, "async p99 not below sync");
+}
+
+// ---------------------------------------------------------------------------
+// yaml: session info parse, string_view parser vs the previous istringstream
+// one. Runs on the generator's 64-driver string, plus the file named by
+// DATA_BENCH_YAML (e.g. a session string captured from the sim) if set.
+// ---------------------------------------------------------------------------
+namespace legacy {
+
+// The parser as it was before the string_view rewrite, kept as a baseline
+using utils::YAMLParser;
+
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, last - first + 1);
+}
+
+std::string extractValue(const std::string& line) {
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) return "";
+    std::string value = line.substr(colon + 1);
+    value = trim(value);
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+        value = value.substr(1, value.length() - 2);
+    return value;
+}
+
+int extractInt(const std::string& line) {
+    std::string v = extractValue(line);
+    try { return std::stoi(v); } catch (...) { return 0; }
+}
+
+float extractFloat(const std::string& line) {
+    std::string v = extractValue(line);
+    try { return std::stof(v); } catch (...) { return 0.0f; }
+}
+
+YAMLParser::SessionInfo parse(const char* yaml) {
+    YAMLParser::SessionInfo info;
+    std::istringstream stream(yaml);
+    std::string line;
+    enum Section { NONE, WEEKEND, DRIVER_INFO, SESSION_INFO };
+    Section section = NONE;
+    bool inDriversList = false;
+    YAMLParser::DriverInfo cur;
+    bool building = false;
+
+    while (std::getline(stream, line)) {
+        int indent = 0;
+        for (char c : line) { if (c == ' ') indent++; else if (c == '\t') indent += 2; else break; }
+        std::string t = trim(line);
+        if (t.empty()) continue;
+
+        if (indent == 0) {
+            size_t cp = t.find(':');
+            if (cp != std::string::npos && trim(t.substr(cp + 1)).empty()) {
+                if (building && section == DRIVER_INFO) { info.drivers.push_back(cur); building = false; }
+                inDriversList = false;
+                std::string name = trim(t.substr(0, cp));
+                if (name == "WeekendInfo") section = WEEKEND;
+                else if (name == "DriverInfo") section = DRIVER_INFO;
+                else if (name == "SessionInfo") section = SESSION_INFO;
+                else section = NONE;
+                continue;
+            }
+        }
+
+        if (section == WEEKEND && indent > 0) {
+            if (t.find("TrackName:") == 0) info.trackName = extractValue(t);
+            else if (t.size() > 10 && t.substr(0, 11) == "SeriesName:") info.seriesName = extractValue(t);
+        }
+
+        if (section == DRIVER_INFO) {
+            if (t == "Drivers:") { inDriversList = true; continue; }
+            if (inDriversList) {
+                if (t[0] == '-') {
+                    if (building) info.drivers.push_back(cur);
+                    cur = YAMLParser::DriverInfo();
+                    building = true;
+                    std::string ad = trim(t.substr(1));
+                    if (!ad.empty() && ad.find("CarIdx:") == 0) cur.carIdx = extractInt(ad);
+                } else if (building && indent >= 2) {
+                    if (t.find("UserName:") == 0) cur.userName = extractValue(t);
+                    else if (t.find("CarNumber:") == 0) cur.carNumber = extractValue(t);
+                    else if (t.find("IRating:") == 0) cur.iRating = extractInt(t);
+                    else if (t.find("LicLevel:") == 0) cur.licenseLevel = extractInt(t);
+                    else if (t.find("LicSubLevel:") == 0) cur.licSubLevel = extractInt(t);
+                    else if (t.find("LicString:") == 0) cur.licString = extractValue(t);
+                    else if (t.find("CarPath:") == 0) cur.carPath = extractValue(t);
+                    else if (t.find("CarClassShortName:") == 0) cur.carClassShortName = extractValue(t);
+                    else if (t.find("ClubName:") == 0) cur.countryCode = extractValue(t);
+                }
+            }
+        }
+
+        if (section == SESSION_INFO && indent > 0) {
+            if (t.find("SessionLaps:") == 0) {
+                std::string v = extractValue(t);
+                info.sessionLaps = (v == "unlimited") ? 999999 : extractInt(t);
+            } else if (t.find("SessionTime:") == 0) {
+                std::string v = extractValue(t);
+                info.sessionTime = (v == "unlimited") ? 999999.0f : extractFloat(t);
+            }
+        }
+    }
+
+    if (building && section == DRIVER_INFO) info.drivers.push_back(cur);
+    return info;
+}
+
+} // namespace legacy
+
+bool sameSessionInfo(const utils::YAMLParser::SessionInfo& a, const utils::YAMLParser::SessionInfo& b) {
+    if (a.seriesName != b.seriesName || a.trackName != b.trackName || a.sessionLaps != b.sessionLaps ||
+        a.sessionTime != b.sessionTime || a.drivers.size() != b.drivers.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.drivers.size(); ++i) {
+        const auto& x = a.drivers[i];
+        const auto& y = b.drivers[i];
+        if (x.carIdx != y.carIdx || x.userName != y.userName || x.carNumber != y.carNumber ||
+            x.iRating != y.iRating || x.licenseLevel != y.licenseLevel || x.licSubLevel != y.licSubLevel ||
+            x.licString != y.licString || x.carPath != y.carPath ||
+            x.carClassShortName != y.carClassShortName || x.countryCode != y.countryCode) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool benchYamlString(const char* name, const std::string& yaml) {
+    bool same = sameSessionInfo(legacy::parse(yaml.c_str()), utils::YAMLParser::parse(yaml.c_str(), yaml.size()));
+
+    double before = nsPerOp(200, [&]() {
+        g_sinkInt = (int)legacy::parse(yaml.c_str()).drivers.size();
+    });
+    double after = nsPerOp(2000, [&]() {
+        g_sinkInt = (int)utils::YAMLParser::parse(yaml.c_str(), yaml.size()).drivers.size();
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s istringstream (%zu KB)", name, yaml.size() / 1024);
+    report("yaml", label, before);
+    snprintf(label, sizeof(label), "%s string_view (%.0f MB/s)", name, yaml.size() / (after * 1e-9) / 1e6);
+    report("yaml", label, after);
+    return check("yaml", same, "parse() differs from the istringstream parser");
+}
+
+bool benchYaml() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    bool ok = benchYamlString("synthetic", race.sessionInfo());
+
+    if (const char* path = getenv("DATA_BENCH_YAML")) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream captured;
+        captured << file.rdbuf();
+        if (file) ok = benchYamlString("captured", captured.str()) && ok;
+        else ok = check("yaml", false, "cannot read DATA_BENCH_YAML");
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// yamlscan: structural pass over the 64-driver session string (newlines,
+// first colon and indentation per line), per scanner implementation and
+// against the find()-per-line walk the parsers did before
+// ---------------------------------------------------------------------------
+bool benchYamlScan() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    SyntheticTelemetry race(config);
+    const std::string yaml = race.sessionInfo();
+    const double bytes = (double)yaml.size();
+    char label[64];
+
+    std::vector<utils::YAMLScanner::Line> lines;
+    double walk = nsPerOp(2000, [&]() {
+        lines.clear();
+        size_t pos = 0;
+        while (pos < yaml.size()) {
+            size_t eol = yaml.find('\n', pos);
+            if (eol == std::string::npos) eol = yaml.size();
+            utils::YAMLScanner::Line line;
+            line.begin = (uint32_t)pos;
+            line.end = (uint32_t)eol;
+            size_t at = pos;
+            for (; at < eol && (yaml[at] == ' ' || yaml[at] == '\t'); ++at) line.indent += yaml[at] == '\t' ? 2 : 1;
+            line.lead = (uint16_t)(at - pos);
+            size_t colon = yaml.find(':', at);
+            line.colon = (uint32_t)std::min(colon, eol);
+            lines.push_back(line);
+            pos = eol + 1;
+        }
+    });
+    snprintf(label, sizeof(label), "find() line walk (%.2f GB/s)", bytes / walk);
+    report("yamlscan", label, walk);
+
+    const utils::YAMLScanner::Isa isas[] = { utils::YAMLScanner::Isa::Scalar, utils::YAMLScanner::Isa::SSE2,
+                                             utils::YAMLScanner::Isa::AVX2 };
+    for (auto isa : isas) {
+        if (isa > utils::YAMLScanner::detectedIsa()) continue;
+        double ns = nsPerOp(2000, [&]() { utils::YAMLScanner::scan(yaml, lines, isa); });
+        snprintf(label, sizeof(label), "scanner %s (%.2f GB/s)", utils::YAMLScanner::isaName(isa), bytes / ns);
+        report("yamlscan", label, ns);
+    }
+
+    double parse = nsPerOp(2000, [&]() {
+        g_sinkInt = (int)utils::YAMLParser::parse(yaml).drivers.size();
+    });
+    snprintf(label, sizeof(label), "parse() (%.2f GB/s)", bytes / parse);
+    report("yamlscan", label, parse);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// sessiondiff: SessionTable::build against the previous table (only changed
+// blocks reparsed) vs a build from scratch, for one edited driver field and
+// for a driver joining. Each incremental table is checked against parse().
+// ---------------------------------------------------------------------------
+bool sameTable(const SessionTable& table, const utils::YAMLParser::SessionInfo& info) {
+    utils::YAMLParser::SessionInfo flat;
+    flat.seriesName = table.seriesName;
+    flat.trackName = table.trackName;
+    flat.sessionLaps = table.sessionLaps;
+    flat.sessionTime = table.sessionTime;
+    for (const auto* d : table.drivers) flat.drivers.push_back(*d);
+    return sameSessionInfo(flat, info);
+}
+
+bool benchSessionDiffCase(const char* name, const std::string& before, const std::string& after) {
+    auto previous = SessionTable::build(before, 1);
+    auto incremental = SessionTable::build(after, 2, previous.get());
+    bool same = sameTable(*incremental, utils::YAMLParser::parse(after));
+
+    double full = nsPerOp(2000, [&]() {
+        g_sinkInt = SessionTable::build(after, 2)->reparsedDrivers;
+    });
+    double diff = nsPerOp(2000, [&]() {
+        g_sinkInt = SessionTable::build(after, 2, previous.get())->reparsedDrivers;
+    });
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s: full build", name);
+    report("sessiondiff", label, full);
+    snprintf(label, sizeof(label), "%s: diff (%d reparsed, %d chg)", name, incremental->reparsedDrivers,
+             (int)std::bitset<64>(incremental->changedDrivers(*previous)).count());
+    report("sessiondiff", label, diff);
+    snprintf(label, sizeof(label), "%s: incremental table differs from parse()", name);
+    return check("sessiondiff", same, label);
+}
+
+bool benchSessionDiff() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.initialCars = SyntheticTelemetry::kMaxCars - 1;
+    SyntheticTelemetry race(config);
+    std::vector<char> mem(race.size(), 0);
+    race.init(mem.data());
+
+    // One driver's iRating edited in place
+    std::string base = race.sessionInfo();
+    std::string edited = base;
+    size_t at = edited.find("IRating: ", edited.find("CarIdx: 10\n"));
+    edited.replace(at, edited.find('\n', at) - at, "IRating: 4321");
+    bool ok = benchSessionDiffCase("edit", base, edited);
+
+    // The last car joining
+    while (!race.step(mem.data())) {}
+    ok = benchSessionDiffCase("join", base, race.sessionInfo()) && ok;
+    ok = benchSessionDiffCase("unchanged", base, base) && ok;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// yamlquery: structural index + path queries vs a full parse, on the
+// generator's string. Every driver's UserName/IRating read by query is
+// checked against parse().
+// ---------------------------------------------------------------------------
+bool benchYamlQuery() {
+    SyntheticTelemetry::Config config;
+    config.cars = SyntheticTelemetry::kMaxCars;
+    config.classes = 5;
+    SyntheticTelemetry race(config);
+    const std::string yaml = race.sessionInfo();
+
+    utils::YAMLIndex index(yaml);
+    auto info = utils::YAMLParser::parse(yaml);
+    int mismatches = 0;
+    for (const auto& d : info.drivers) {
+        char path[64];
+        std::string_view name;
+        int iRating = 0;
+        snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}UserName:", d.carIdx);
+        if (!index.get(path, name) || name != d.userName) ++mismatches;
+        snprintf(path, sizeof(path), "DriverInfo:Drivers:CarIdx:{%d}IRating:", d.carIdx);
+        if (!index.getInt(path, iRating) || iRating != d.iRating) ++mismatches;
+    }
+    std::vector<int> classIds;
+    for (const auto& d : info.drivers) {
+        if (std::find(classIds.begin(), classIds.end(), d.carClassId) == classIds.end()) classIds.push_back(d.carClassId);
+    }
+    int numClasses = 0;
+    if (!index.getInt("WeekendInfo:NumCarClasses:", numClasses) || numClasses != (int)classIds.size()) ++mismatches;
+
+    double parse = nsPerOp(2000, [&]() {
+        g_sinkInt = (int)utils::YAMLParser::parse(yaml).drivers.size();
+    });
+    double build = nsPerOp(2000, [&]() {
+        index.build(yaml);
+        g_sinkInt = (int)index.nodeCount();
+    });
+    const char* kPath = "DriverInfo:Drivers:CarIdx:{63}UserName:";
+    double query = nsPerOp(200000, [&]() {
+        std::string_view v;
+        index.get(kPath, v);
+        g_sinkInt = (int)v.size();
+    });
+    utils::YAMLQuery cached(kPath);
+    double hit = nsPerOp(2000000, [&]() {
+        g_sinkInt = (int)cached.get(index).size();
+    });
+
+    char label[64];
+    report("yamlquery", "full parse", parse);
+    snprintf(label, sizeof(label), "index build (%zu nodes)", index.nodeCount());
+    report("yamlquery", label, build);
+    report("yamlquery", "query last driver", query);
+    report("yamlquery", "cached query", hit);
+    return check("yamlquery", mismatches == 0, "queried values differ from parse()");
+}
+
+struct Scenario {
+    const char* name;
+    bool (*run)();  // false when one of its checks failed
+};
+
+const Scenario kScenarios[] = {
+    { "varlookup", benchVarLookup },
+    { "synthetic", benchSynthetic },
+    { "torn", benchTorn },
+    { "carframe", benchCarFrame },
+    { "relative", benchRelative },
+    { "order", benchOrder },
+    { "gaps", benchGaps },
+    { "laps", benchLaps },
+    { "sectors", benchSectors },
+    { "delta", benchDelta },
+    { "pits", benchPits },
+    { "irating", benchIRating },
+    { "dirty", benchDirty },
+    { "alloc", benchAlloc },
+    { "joinstorm", benchJoinStorm },
+    { "yaml", benchYaml },
+    { "yamlscan", benchYamlScan },
+    { "sessiondiff", benchSessionDiff },
+    { "yamlquery", benchYamlQuery },
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int failed = 0, ran = 0;
+    for (const Scenario& scenario : kScenarios) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], scenario.name) == 0) selected = true;
+        }
+        if (!selected) continue;
+        ++ran;
+        if (!scenario.run()) {
+            printf("%-12s FAILED\n", scenario.name);
+            ++failed;
+        }
+    }
+    if (ran == 0) {
+        printf("unknown scenario\n");
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
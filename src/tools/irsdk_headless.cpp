@@ -0,0 +1,302 @@
+// irsdk_headless - runs the ingestion + RelativeCalculator pipeline without
+// a window and reports write-to-consume latency and ingest counters.
+//
+// Usage: irsdk_headless [--seconds S] [--fps HZ] [--record OUT [--verify ...]]
+//                       [--ibt FILE [--speed X | --max-speed]] [--check-gaps]
+// Latency needs a publisher that stamps WriterTimestamp (irsdk_writer).
+// With --max-speed an .ibt file is replayed record by record as fast as the
+// pipeline consumes it, which makes a reproducible throughput benchmark.
+// --record writes every ingested tick to OUT and then decodes it again to
+// report the compression ratio and check the round trip. With --verify,
+// followed by the irsdk_writer race options the publisher was started
+// with (--seed, --cars, --rate, ...), every decoded row is compared byte
+// for byte with the same race regenerated here. The ratio includes the
+// session YAML, stored as is: a short run is dominated by it, and it only
+// amortises over minutes of rows.
+// --check-gaps compares GapTimer's gaps to the leader with CarIdxF2Time on
+// every tick that has both, to validate the fallback on recorded data.
+
+#include "data/car_frame.h"
+#include "data/gap_timer.h"
+#include "data/ibt_playback.h"
+#include "data/irsdk_manager.h"
+#include "data/irsdk_layout.h"
+#include "data/relative_calc.h"
+#include "data/synthetic_telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace iracing;
+
+namespace {
+
+struct Options {
+    double seconds = 10.0;
+    int fps = 60;
+    const char* ibt = nullptr;
+    double speed = 1.0;
+    bool maxSpeed = false;
+    const char* record = nullptr;
+    bool checkGaps = false;
+    bool verify = false;
+    SyntheticTelemetry::Config race;  // the publisher's, for --verify
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--max-speed") == 0) opt.maxSpeed = true;
+        else if (strcmp(argv[i], "--check-gaps") == 0) opt.checkGaps = true;
+        else if (strcmp(argv[i], "--verify") == 0) opt.verify = true;
+        else if (!hasValue) break;
+        else if (strcmp(argv[i], "--seconds") == 0) opt.seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--fps") == 0) opt.fps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ibt") == 0) opt.ibt = argv[++i];
+        else if (strcmp(argv[i], "--speed") == 0) opt.speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0) opt.record = argv[++i];
+        else if (strcmp(argv[i], "--rate") == 0) opt.race.tickRate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cars") == 0) opt.race.cars = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0) opt.race.seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--initial-cars") == 0) opt.race.initialCars = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--join-every") == 0) opt.race.joinInterval = atof(argv[++i]);
+        else if (strcmp(argv[i], "--pit-chance") == 0) opt.race.pitChance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--classes") == 0) opt.race.classes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pace-car") == 0) opt.race.paceCar = atoi(argv[++i]) != 0;
+    }
+    if (opt.fps < 1) opt.fps = 1;
+    return opt;
+}
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, (size_t)(p * (values.size() - 1)));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+class GapCheck {
+public:
+    void sample(const IRSDKManager& sdk) {
+        if (sdk.getHeaderGeneration() != m_generation) {
+            m_sessionTime = sdk.getVarHandle("SessionTime");
+            m_generation = sdk.getHeaderGeneration();
+            m_timer.reset();
+        }
+        if (sdk.getSnapshot().tickCount() == m_frame.tickCount) return;
+        if (!m_reader.read(sdk, m_frame)) return;
+        m_timer.update(m_frame, sdk.getDouble(m_sessionTime));
+
+        int leader = -1;
+        for (int i = 0; i < m_frame.carCount; ++i) {
+            if (m_frame.isInWorld(i) && m_frame.position[i] == 1) leader = i;
+        }
+        if (leader < 0) return;
+        for (int i = 0; i < m_frame.carCount; ++i) {
+            const float f2 = m_frame.f2Time[i] - m_frame.f2Time[leader];
+            if (i == leader || !m_frame.isInWorld(i) || m_frame.f2Time[i] <= 0.0f) continue;
+            ++m_pairs;
+            float gap = 0.0f;
+            if (m_timer.gap(i, leader, gap)) m_errors.push_back(std::abs(gap - f2));
+        }
+    }
+
+    void report() {
+        std::cout << "[Headless] gaps vs F2Time: pairs=" << m_pairs << " timed=" << m_errors.size();
+        if (!m_errors.empty()) {
+            double mean = 0.0;
+            for (double e : m_errors) mean += e;
+            mean /= m_errors.size();
+            std::cout << " |error| mean=" << mean << " s p50=" << percentile(m_errors, 0.50)
+                      << " s p99=" << percentile(m_errors, 0.99) << " s max=" << percentile(m_errors, 1.0) << " s";
+        }
+        std::cout << "\n";
+    }
+
+private:
+    int m_generation = -1;
+    VarHandle m_sessionTime;
+    CarFrameReader m_reader;
+    CarFrame m_frame;
+    GapTimer m_timer;
+    long m_pairs = 0;
+    std::vector<double> m_errors;
+};
+
+// Decodes the recording again; with race, each row is compared with the
+// row the regenerated race publishes at the same tick (WriterTimestamp,
+// the publisher's wall clock, is taken from the recorded row)
+bool verifyRecording(const char* path, const TelemetryRecorder::Stats& stats,
+                     const SyntheticTelemetry::Config* race) {
+    RecordingReader reader;
+    if (!reader.open(path)) {
+        std::cout << "[Headless] recording: cannot read back " << path << "\n";
+        return false;
+    }
+
+    std::unique_ptr<SyntheticTelemetry> replay;
+    std::vector<char> mem;
+    int timestampOffset = -1;
+    if (race) {
+        replay = std::make_unique<SyntheticTelemetry>(*race);
+        mem.assign(replay->size(), 0);
+        replay->init(mem.data());
+        for (const irsdk_varHeader& var : reader.varHeaders()) {
+            if (strcmp(var.name, "WriterTimestamp") == 0 && var.type == irsdk_double) timestampOffset = var.offset;
+        }
+    }
+
+    uint64_t rows = 0, sessions = 0, sessionBytes = 0, compared = 0, mismatched = 0;
+    for (;;) {
+        RecordingReader::Record record = reader.next();
+        if (record == RecordingReader::Record::End) break;
+        if (record != RecordingReader::Record::Row) {
+            ++sessions;
+            sessionBytes += reader.sessionInfo().size();
+            continue;
+        }
+        ++rows;
+        if (!replay) continue;
+
+        const std::vector<char>& row = reader.row();
+        double timestamp = 0.0;
+        if (timestampOffset >= 0) memcpy(&timestamp, row.data() + timestampOffset, sizeof(timestamp));
+        while (replay->tick() < reader.tickCount()) {
+            const bool last = replay->tick() + 1 == reader.tickCount();
+            replay->step(mem.data(), last ? timestamp : 0.0);
+        }
+        ++compared;
+        const char* expected = IRSDKLayout::rowForTick(mem.data(), replay->tick());
+        if (replay->tick() != reader.tickCount() || (int)row.size() != reader.bufLen() ||
+            memcmp(row.data(), expected, row.size()) != 0) {
+            if (mismatched++ == 0) std::cout << "[Headless] first mismatched row: tick " << reader.tickCount() << "\n";
+        }
+    }
+
+    const double rawBytes = (double)stats.rawBytes;
+    std::cout << "[Headless] recording rows=" << stats.rows << " dropped=" << stats.dropped
+              << " raw=" << stats.rawBytes << " B written=" << stats.writtenBytes << " B ("
+              << (rawBytes > 0.0 ? 100.0 * stats.writtenBytes / rawBytes : 0.0) << "% of raw, "
+              << (rawBytes > 0.0 ? 100.0 * (stats.writtenBytes - sessionBytes) / rawBytes : 0.0)
+              << "% without the " << sessionBytes << " B of session YAML)\n";
+    bool ok = rows == stats.rows;
+    std::cout << "[Headless] recording decoded rows=" << rows << " sessionInfo=" << sessions
+              << (ok ? " OK" : " MISMATCH") << "\n";
+    if (replay) {
+        ok = ok && compared > 0 && mismatched == 0;
+        std::cout << "[Headless] recording rows against the regenerated race: " << compared << " compared, "
+                  << mismatched << " differ" << (compared > 0 && mismatched == 0 ? " OK" : " MISMATCH") << "\n";
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt = parseOptions(argc, argv);
+
+    IRSDKManager sdk;
+    sdk.setIngestThreadEnabled(true);
+    RelativeCalculator relative(&sdk);
+    std::unique_ptr<GapCheck> gapCheck;
+    if (opt.checkGaps) gapCheck = std::make_unique<GapCheck>();
+
+    using clock = std::chrono::steady_clock;
+
+    IbtPlayback* playback = nullptr;
+    if (opt.ibt) {
+        auto file = std::make_unique<IbtPlayback>(opt.ibt);
+        file->setSpeed(opt.speed);
+        file->setMaxSpeed(opt.maxSpeed);
+        playback = file.get();
+        sdk.setTransport(std::move(file));
+    }
+
+    if (playback && opt.maxSpeed) {
+        // Unpaced replay: one record per update until the file ends
+        const auto start = clock::now();
+        long records = 0;
+        sdk.update();
+        relative.update();
+        while (sdk.isConnected() && !playback->isFinished()) {
+            sdk.update();
+            relative.update();
+            if (gapCheck) gapCheck->sample(sdk);
+            ++records;
+        }
+        double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << "[Headless] replayed " << records << " records in " << seconds << " s ("
+                  << (seconds > 0.0 ? records / seconds : 0.0) << " records/s, "
+                  << (records > 0 ? seconds * 1e9 / records : 0.0) << " ns/record)\n";
+        std::cout << "[Headless] drivers=" << relative.getAllDrivers().size()
+                  << " sof=" << relative.getSOF() << "\n";
+        if (gapCheck) gapCheck->report();
+        return records > 0 ? 0 : 1;
+    }
+
+    const auto start = clock::now();
+    const auto frame = std::chrono::duration<double>(1.0 / opt.fps);
+
+    VarHandle writerTimestamp;
+    int generation = -1;
+    std::vector<double> latencyUs;
+    latencyUs.reserve((size_t)(opt.seconds * 400));
+    long frames = 0;
+    long ticks = 0;
+    bool recordingStarted = false;
+
+    while (clock::now() - start < std::chrono::duration<double>(opt.seconds)) {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<clock::duration>(frame * frames));
+        ++frames;
+
+        if (opt.record && !recordingStarted && sdk.isConnected()) {
+            recordingStarted = sdk.startRecording(opt.record);
+        }
+
+        ticks += sdk.update([&]() {
+            if (sdk.getHeaderGeneration() != generation) {
+                writerTimestamp = sdk.getVarHandle("WriterTimestamp");
+                generation = sdk.getHeaderGeneration();
+            }
+            const char* row = sdk.getSnapshot().data();
+            if (writerTimestamp.isValid() && writerTimestamp.type == irsdk_double && row) {
+                double written = *reinterpret_cast<const double*>(row + writerTimestamp.offset);
+                double now = std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+                latencyUs.push_back((now - written) * 1e6);
+            }
+            if (gapCheck) gapCheck->sample(sdk);
+        });
+        relative.update();
+    }
+
+    SnapshotRing::Stats stats = sdk.getIngestStats();
+    std::cout << "[Headless] frames=" << frames << " ticks=" << ticks
+              << " drivers=" << relative.getAllDrivers().size() << " sof=" << relative.getSOF() << "\n";
+    std::cout << "[Headless] relative computed=" << relative.getUpdatesComputed()
+              << " skipped=" << relative.getUpdatesSkipped() << "\n";
+    std::cout << "[Headless] ingest produced=" << stats.produced << " consumed=" << stats.consumed
+              << " dropped=" << stats.dropped << " missed=" << stats.missed << "\n";
+    if (!latencyUs.empty()) {
+        std::cout << "[Headless] write->consume latency us: p50=" << percentile(latencyUs, 0.50)
+                  << " p99=" << percentile(latencyUs, 0.99)
+                  << " max=" << percentile(latencyUs, 1.0) << "\n";
+    }
+
+    if (gapCheck) gapCheck->report();
+
+    bool verified = true;
+    if (recordingStarted) {
+        sdk.stopRecording();
+        verified = verifyRecording(opt.record, sdk.getRecordingStats(), opt.verify ? &opt.race : nullptr);
+    }
+
+    sdk.shutdown();
+    return ticks > 0 && verified ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// irsdk_writer - publishes a live irsdk layout through the shared-memory
+// transport so IRSDKManager (and irsdk_headless) can run without the sim.
+// Rows come from SyntheticTelemetry, so a given --seed always replays the
+// same race.
+//
+// Usage: irsdk_writer [--rate HZ] [--cars N] [--seconds S] [--seed N]
+//                     [--initial-cars N] [--join-every S] [--pit-chance P] [--classes N]
+//                     [--pace-car 0|1]
+
+#include "data/shared_memory_writer.h"
+#include "data/synthetic_telemetry.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+using namespace iracing;
+
+namespace {
+
+struct Options {
+    SyntheticTelemetry::Config race;
+    double seconds = 0.0;  // 0 = run until killed
+};
+
+Options parseOptions(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--rate") == 0) opt.race.tickRate = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--cars") == 0) opt.race.cars = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seconds") == 0) opt.seconds = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) opt.race.seed = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--initial-cars") == 0) opt.race.initialCars = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--join-every") == 0) opt.race.joinInterval = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--pit-chance") == 0) opt.race.pitChance = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--classes") == 0) opt.race.classes = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--pace-car") == 0) opt.race.paceCar = atoi(argv[i + 1]) != 0;
+    }
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt = parseOptions(argc, argv);
+    SyntheticTelemetry race(opt.race);
+    const SyntheticTelemetry::Config& cfg = race.config();
+
+    SharedMemoryWriter writer;
+    if (!writer.create(race.size())) {
+        std::cerr << "[Writer] Failed to create shared memory" << std::endl;
+        return 1;
+    }
+
+    char* mem = writer.data();
+    race.init(mem);
+    writer.signalDataValid();
+
+    std::cout << "[Writer] Publishing " << race.activeCars() << "/" << cfg.cars << " cars at "
+              << cfg.tickRate << " Hz (seed " << cfg.seed << ")" << std::endl;
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto period = std::chrono::duration<double>(1.0 / cfg.tickRate);
+    const int totalTicks = opt.seconds > 0.0 ? (int)(opt.seconds * cfg.tickRate) : -1;
+    int joins = 0;
+
+    for (int tick = 1; totalTicks < 0 || tick <= totalTicks; ++tick) {
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<clock::duration>(period * tick));
+
+        double now = std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+        if (race.step(mem, now)) ++joins;
+        writer.signalDataValid();
+    }
+
+    IRSDKLayout::setConnected(mem, false);
+    std::cout << "[Writer] Done, " << race.activeCars() << " cars, " << joins << " session info updates" << std::endl;
+    return 0;
+}
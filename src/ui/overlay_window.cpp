@@ -2,6 +2,7 @@
 #include "ui/relative_widget.h"
 #include "ui/telemetry_widget.h"
 #include "data/irsdk_manager.h"
+#include "data/ibt_playback.h"
 #include "data/relative_calc.h"
 #include "utils/config.h"
 #include <imgui.h>
@@ -88,11 +89,21 @@ bool OverlayWindow::initialize(const char* title, int width, int height) {
 
     // Create SDK
     m_sdk = std::make_unique<iracing::IRSDKManager>();
+    m_sdk->setIngestThreadEnabled(true);  // sample every tick off the vsync loop
     m_relative = std::make_unique<iracing::RelativeCalculator>(m_sdk.get());
+    m_relative->setRelativeMode(utils::Config::getInstance().trackRelative ? iracing::RelativeMode::Track
+                                                                           : iracing::RelativeMode::Race);
+    m_relative->setReferenceLapDir(utils::Config::getInstance().referenceLapDir);
 
     return true;
 }
 
+void OverlayWindow::openPlayback(const char* path) {
+    if (!m_sdk || !path) return;
+    std::cout << "[OverlayWindow] Playing back " << path << std::endl;
+    m_sdk->setTransport(std::make_unique<iracing::IbtPlayback>(path));
+}
+
 void OverlayWindow::setupImGui() {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -24,6 +24,9 @@ public:
     void run();
     void shutdown();
 
+    // Replay an .ibt telemetry file instead of the live sim
+    void openPlayback(const char* path);
+
 private:
     void setupImGui();
 
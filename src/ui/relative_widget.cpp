@@ -71,7 +71,7 @@ void RelativeWidget::loadCarBrandTextures() {
     }
 }
 
-unsigned int RelativeWidget::getCarBrandTexture(const std::string& brand) const {
+unsigned int RelativeWidget::getCarBrandTexture(std::string_view brand) const {
     auto it = m_carBrandTextures.find(brand);
     return (it != m_carBrandTextures.end()) ? it->second : 0;
 }
@@ -82,8 +82,20 @@ void RelativeWidget::render(iracing::RelativeCalculator* relative, bool editMode
     utils::Config& config = utils::Config::getInstance();
     bool locked = !editMode && config.uiLocked;
 
-    auto drivers = relative->getRelative(4, 4);
+    // Header text only changes with new results; the rows are a view into
+    // the calculator's driver table and cost nothing to fetch per frame
+    if (relative->getResultsVersion() != m_cachedVersion) {
+        m_series = relative->getSeriesName();
+        if (m_series.empty() || m_series == "Unknown Series") {
+            m_series = "Practice Session";
+        }
+        m_lapInfo = relative->getLapInfo();
+        m_cachedVersion = relative->getResultsVersion();
+    }
+    const iracing::DriverView drivers = relative->getRelative(4, 4);
     if (drivers.empty()) return;
+    m_trackMode = relative->getRelativeMode() == iracing::RelativeMode::Track;
+    m_multiClass = relative->isMultiClass();
 
     ImGuiWindowFlags flags = ImGuiWindowFlags_AlwaysAutoResize;
     if (!locked) {
@@ -132,7 +144,7 @@ void RelativeWidget::render(iracing::RelativeCalculator* relative, bool editMode
 
         // Render all drivers
         for (const auto& driver : drivers) {
-            renderDriverRow(driver, driver.isPlayer, buffer);
+            renderDriverRow(driver, relative->strings(), driver.isPlayer, buffer);
         }
 
         ImGui::EndTable();
@@ -149,12 +161,9 @@ void RelativeWidget::render(iracing::RelativeCalculator* relative, bool editMode
 }
 
 void RelativeWidget::renderHeader(iracing::RelativeCalculator* relative) {
-    std::string series = relative->getSeriesName();
-    if (series.empty() || series == "Unknown Series") {
-        series = "Practice Session";
-    }
-    std::string lapInfo = relative->getLapInfo();
-    int sof = relative->getSOF();
+    const std::string& series = m_series;
+    const std::string& lapInfo = m_lapInfo;
+    int sof = relative->getPlayerClassSOF();
 
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
 
@@ -187,7 +196,8 @@ void RelativeWidget::renderHeader(iracing::RelativeCalculator* relative) {
     ImGui::PopStyleVar();
 }
 
-void RelativeWidget::renderDriverRow(const iracing::Driver& driver, bool isPlayer, char* buffer) {
+void RelativeWidget::renderDriverRow(const iracing::Driver& driver, const utils::StringPool& strings, bool isPlayer,
+                                     char* buffer) {
     ImGui::TableNextRow();
     float rowH = ImGui::GetTextLineHeight();
 
@@ -202,7 +212,7 @@ void RelativeWidget::renderDriverRow(const iracing::Driver& driver, bool isPlaye
     if (driver.isOnPit) {
         ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "PIT");
     } else {
-        ImGui::Text("P%d", driver.relativePosition);
+        ImGui::Text("P%d", m_multiClass ? driver.classPosition : driver.relativePosition);
     }
 
     // === Col 2: Car Brand Logo ===
@@ -210,7 +220,7 @@ void RelativeWidget::renderDriverRow(const iracing::Driver& driver, bool isPlaye
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + rowH * 0.15f);
     {
         float logoSize = 16.0f * m_scale;
-        unsigned int tex = getCarBrandTexture(driver.carBrand);
+        unsigned int tex = getCarBrandTexture(strings.view(driver.carBrand));
         if (tex) {
             ImGui::Image((ImTextureID)(intptr_t)tex, ImVec2(logoSize, logoSize));
         } else {
@@ -228,21 +238,21 @@ void RelativeWidget::renderDriverRow(const iracing::Driver& driver, bool isPlaye
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + rowH * 0.05f);
     {
         // Club/country flag
-        const char* flag = getClubFlag(driver.countryCode);
+        const char* flag = getClubFlag(strings.view(driver.countryCode));
         if (flag && flag[0] != '\0') {
             ImGui::TextColored(ImVec4(0.7f, 0.8f, 0.9f, 1.0f), "%s", flag);
             ImGui::SameLine(0, 4);
         }
 
         // Car number (yellow, bold)
-        ImGui::TextColored(ImVec4(1.0f, 0.95f, 0.3f, 1.0f), "#%s", driver.carNumber.c_str());
+        ImGui::TextColored(ImVec4(1.0f, 0.95f, 0.3f, 1.0f), "#%s", strings.c_str(driver.carNumber));
         ImGui::SameLine(0, 6);
 
         // Driver name
         if (isPlayer) {
-            ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.5f, 1.0f), "%s", driver.driverName.c_str());
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.5f, 1.0f), "%s", strings.c_str(driver.driverName));
         } else {
-            ImGui::Text("%s", driver.driverName.c_str());
+            ImGui::Text("%s", strings.c_str(driver.driverName));
         }
     }
 
@@ -350,17 +360,26 @@ void RelativeWidget::renderDriverRow(const iracing::Driver& driver, bool isPlaye
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + rowH * 0.15f);
     {
         formatTime(driver.lastLapTime, buffer);
-        ImGui::Text("%s", buffer);
+        // The car's personal best in green
+        if (driver.lastLapTime > 0.0f && driver.lastLapTime == driver.bestLapTime) {
+            ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "%s", buffer);
+        } else {
+            ImGui::Text("%s", buffer);
+        }
     }
 
     // === Col 7: Gap ===
     ImGui::TableNextColumn();
     ImGui::SetCursorPosY(ImGui::GetCursorPosY() + rowH * 0.15f);
     {
-        formatGap(driver.gapToPlayer, buffer);
+        // Track mode rows are ordered by track position, so are their gaps
+        const float gap = m_trackMode ? driver.trackGap : driver.gapToPlayer;
+        formatGap(gap, buffer);
         if (driver.isPlayer) {
             ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "---");
-        } else if (driver.gapToPlayer > 0) {
+        } else if (m_trackMode && !driver.trackGapValid) {
+            // No lap time to turn the distance into seconds yet
+        } else if (gap > 0) {
             ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", buffer);
         } else {
             ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "%s", buffer);
@@ -387,6 +406,29 @@ void RelativeWidget::renderFooter(iracing::RelativeCalculator* relative) {
     ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 1.0f), "Last: %s", lastBuf);
     ImGui::SameLine(0, 16);
     ImGui::TextColored(ImVec4(0.6f, 1.0f, 0.6f, 1.0f), "Best: %s", bestBuf);
+
+    // Live delta to the reference lap and the lap time it points to
+    const iracing::LapDelta& lapDelta = relative->getLapDelta();
+    float delta = 0.0f, predicted = 0.0f;
+    if (lapDelta.delta(delta) && lapDelta.predictedLapTime(predicted)) {
+        char predBuf[32];
+        formatTime(predicted, predBuf);
+        ImGui::SameLine(0, 16);
+        if (delta > 0.0f) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%+.2f", delta);
+        } else {
+            ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "%+.2f", delta);
+        }
+        ImGui::SameLine(0, 8);
+        ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 1.0f), "Pred: %s", predBuf);
+    }
+
+    // Rejoin position if the player pitted this lap
+    const iracing::PitRejoin& rejoin = relative->getPitRejoin();
+    if (rejoin.valid) {
+        ImGui::SameLine(0, 16);
+        ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Pit: P%d (%.0fs)", rejoin.position, rejoin.pitLoss);
+    }
 }
 
 void RelativeWidget::formatGap(float gap, char* buffer) {
@@ -431,7 +473,7 @@ void RelativeWidget::getSafetyRatingColor(float sr, float& r, float& g, float& b
     else                 { r = 1.0f; g = 0.0f; b = 0.0f; }   // Red - R
 }
 
-const char* RelativeWidget::getClubFlag(const std::string& club) {
+const char* RelativeWidget::getClubFlag(std::string_view club) {
     (void)club;
     return "";
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
 
 namespace iracing {
@@ -8,6 +10,10 @@ namespace iracing {
     struct Driver;
 }
 
+namespace utils {
+    class StringPool;
+}
+
 namespace ui {
     class OverlayWindow;
 
@@ -20,7 +26,8 @@ namespace ui {
 
     private:
         void renderHeader(iracing::RelativeCalculator* relative);
-        void renderDriverRow(const iracing::Driver& driver, bool isPlayer, char* buffer);
+        void renderDriverRow(const iracing::Driver& driver, const utils::StringPool& strings, bool isPlayer,
+                             char* buffer);
         void renderFooter(iracing::RelativeCalculator* relative);
 
         void formatGap(float gap, char* buffer);
@@ -28,18 +35,25 @@ namespace ui {
 
         const char* getSafetyRatingLetter(float sr);
         void getSafetyRatingColor(float sr, float& r, float& g, float& b);
-        const char* getClubFlag(const std::string& club);
+        const char* getClubFlag(std::string_view club);
 
         // Car brand logo textures
         void loadCarBrandTextures();
         unsigned int loadTextureFromFile(const char* filepath);
-        unsigned int getCarBrandTexture(const std::string& brand) const;
+        unsigned int getCarBrandTexture(std::string_view brand) const;
 
         OverlayWindow* m_overlay = nullptr;
         float m_scale = 1.0f;
+        bool m_trackMode = false;  // gaps by track position (RelativeMode::Track)
+        bool m_multiClass = false; // positions and SOF within the player's class
+
+        // Header text from the last RelativeCalculator results
+        uint64_t m_cachedVersion = UINT64_MAX;
+        std::string m_series;
+        std::string m_lapInfo;
 
-        // brand name -> OpenGL texture ID
-        std::map<std::string, unsigned int> m_carBrandTextures;
+        // brand name -> OpenGL texture ID (looked up by string_view)
+        std::map<std::string, unsigned int, std::less<>> m_carBrandTextures;
     };
 
 } // namespace ui
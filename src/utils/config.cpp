@@ -49,6 +49,8 @@ void Config::load(const std::string& filename) {
             else if (key == "Alpha") config.alpha = std::stof(value);
             else if (key == "Visible") config.visible = (value == "true" || value == "1");
             else if (key == "UILocked") config.uiLocked = (value == "true" || value == "1");
+            else if (key == "RelativeMode") config.trackRelative = (value == "track");
+            else if (key == "ReferenceLapDir") config.referenceLapDir = value;
         } catch (...) {
             std::cerr << "[Config] Error parsing: " << key << "=" << value << std::endl;
         }
@@ -75,6 +77,8 @@ void Config::save(const std::string& filename) {
     file << "Alpha=" << config.alpha << "\n";
     file << "Visible=" << (config.visible ? "true" : "false") << "\n";
     file << "UILocked=" << (config.uiLocked ? "true" : "false") << "\n";
+    file << "RelativeMode=" << (config.trackRelative ? "track" : "race") << "\n";
+    file << "ReferenceLapDir=" << config.referenceLapDir << "\n";
 
     file.close();
     std::cout << "[Config] Saved successfully" << std::endl;
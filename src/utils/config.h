@@ -25,6 +25,8 @@ public:
     float alpha = 0.9f;
     bool visible = true;
     bool uiLocked = true;  // Start locked
+    bool trackRelative = false;  // RelativeMode: "race" order or "track" position
+    std::string referenceLapDir = "laps";  // ReferenceLapDir: delta reference laps, empty = not saved
 
     // Load/Save
     static void load(const std::string& filename = "config.ini");
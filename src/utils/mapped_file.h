@@ -0,0 +1,35 @@
+#ifndef UTILS_MAPPED_FILE_H
+#define UTILS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace utils {
+
+// Read-only memory mapping of a whole file. Pages are loaded on demand by
+// the OS, so multi-GB files cost address space, not RAM.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_file = nullptr;     // HANDLE on Win32
+    void* m_mapping = nullptr;  // HANDLE on Win32
+};
+
+} // namespace utils
+
+#endif // UTILS_MAPPED_FILE_H
@@ -0,0 +1,61 @@
+#include "utils/string_pool.h"
+#include <algorithm>
+
+namespace utils {
+
+namespace {
+
+uint32_t hashString(std::string_view str) {
+    uint32_t h = 2166136261u;  // FNV-1a; pooled strings are short
+    for (char c : str) h = (h ^ (uint8_t)c) * 16777619u;
+    return h;
+}
+
+} // namespace
+
+StringPool::StringPool() {
+    m_arena.reserve(4096);
+    m_entries.reserve(256);
+    clear();
+    rehash(512);
+}
+
+void StringPool::clear() {
+    m_arena.clear();
+    m_entries.clear();
+    m_arena.push_back('\0');
+    m_entries.push_back({ 0, 0 });
+    std::fill(m_slots.begin(), m_slots.end(), kEmptyString);
+}
+
+StringId StringPool::intern(std::string_view str) {
+    if (str.empty()) return kEmptyString;
+
+    // Kept at most half full
+    if ((m_entries.size() + 1) * 2 > m_slots.size()) rehash(m_slots.size() * 2);
+
+    const size_t mask = m_slots.size() - 1;
+    size_t slot = hashString(str) & mask;
+    for (; m_slots[slot] != kEmptyString; slot = (slot + 1) & mask) {
+        if (view(m_slots[slot]) == str) return m_slots[slot];
+    }
+
+    const StringId id = (StringId)m_entries.size();
+    m_entries.push_back({ (uint32_t)m_arena.size(), (uint32_t)str.size() });
+    m_arena.insert(m_arena.end(), str.begin(), str.end());
+    m_arena.push_back('\0');
+    m_slots[slot] = id;
+    return id;
+}
+
+void StringPool::rehash(size_t slots) {
+    m_slots.assign(slots, kEmptyString);
+    const size_t mask = slots - 1;
+    for (StringId id = 1; id < m_entries.size(); ++id) {
+        size_t slot = hashString(view(id)) & mask;
+        while (m_slots[slot] != kEmptyString) slot = (slot + 1) & mask;
+        m_slots[slot] = id;
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,53 @@
+#ifndef UTILS_STRING_POOL_H
+#define UTILS_STRING_POOL_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// Handle to a string in a StringPool; 0 is always the empty string
+using StringId = uint32_t;
+constexpr StringId kEmptyString = 0;
+
+// Interner for the per-session strings (names, car numbers, classes):
+// each distinct string is stored once, NUL-terminated, in one arena and
+// referred to by a 4-byte id. clear() keeps every buffer, so rebuilding
+// the pool for a new session string stops allocating once it has seen
+// the largest session.
+class StringPool {
+public:
+    StringPool();
+
+    StringId intern(std::string_view str);
+
+    std::string_view view(StringId id) const {
+        const Entry& e = m_entries[id < m_entries.size() ? id : kEmptyString];
+        return std::string_view(m_arena.data() + e.offset, e.length);
+    }
+    const char* c_str(StringId id) const { return view(id).data(); }
+
+    // Drops every string except the empty one; ids handed out before are
+    // invalid afterwards
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+    size_t arenaBytes() const { return m_arena.size(); }
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    void rehash(size_t slots);
+
+    std::vector<char> m_arena;
+    std::vector<Entry> m_entries;
+    std::vector<StringId> m_slots;  // open addressing, 0 = free (the empty string is not hashed)
+};
+
+} // namespace utils
+
+#endif // UTILS_STRING_POOL_H
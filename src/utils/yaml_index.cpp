@@ -0,0 +1,230 @@
+#include "utils/yaml_index.h"
+#include "utils/yaml_scanner.h"
+#include <atomic>
+#include <charconv>
+
+namespace utils {
+
+namespace {
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view trimRight(std::string_view str) {
+    while (!str.empty() && isBlank(str.back())) str.remove_suffix(1);
+    return str;
+}
+
+std::string_view trimLeft(std::string_view str) {
+    while (!str.empty() && isBlank(str.front())) str.remove_prefix(1);
+    return str;
+}
+
+std::string_view unquote(std::string_view value) {
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') return value.substr(1, value.size() - 2);
+    return value;
+}
+
+bool toInt(std::string_view v, int& out) {
+    if (!v.empty() && v.front() == '+') v.remove_prefix(1);
+    return std::from_chars(v.data(), v.data() + v.size(), out).ec == std::errc();
+}
+
+bool toFloat(std::string_view v, float& out) {
+    if (!v.empty() && v.front() == '+') v.remove_prefix(1);
+    return std::from_chars(v.data(), v.data() + v.size(), out).ec == std::errc();
+}
+
+std::atomic<uint64_t> g_generation{0};
+
+} // namespace
+
+void YAMLIndex::build(std::string_view yaml) {
+    m_text = yaml;
+    m_nodes.clear();
+    m_generation = ++g_generation;
+
+    // Nodes whose subtree is still open, innermost last. A line closes
+    // every open node at a deeper column; at the same column it closes a
+    // key (siblings) but a list item only closes an item, since list
+    // entries may sit at their parent key's column.
+    std::vector<uint32_t> open;
+    auto closeTo = [&](int column, bool item) {
+        while (!open.empty()) {
+            Node& top = m_nodes[open.back()];
+            if (top.column < column || (top.column == column && item && !top.item)) break;
+            top.end = (uint32_t)m_nodes.size();
+            open.pop_back();
+        }
+    };
+    auto push = [&](const Node& node) {
+        open.push_back((uint32_t)m_nodes.size());
+        m_nodes.push_back(node);
+    };
+
+    thread_local std::vector<YAMLScanner::Line> lines;
+    YAMLScanner::scan(yaml, lines);
+
+    for (const YAMLScanner::Line& line : lines) {
+        int column = line.indent;
+        std::string_view rest = trimRight(yaml.substr(line.contentBegin(), line.end - line.contentBegin()));
+        if (rest.empty()) continue;
+
+        if (rest[0] == '-' && (rest.size() == 1 || isBlank(rest[1]))) {
+            closeTo(column, true);
+            Node item;
+            item.column = (int16_t)column;
+            item.item = true;
+            std::string_view entry = trimLeft(rest.substr(1));
+            if (line.colon == line.end) {
+                // Scalar list entry ("- value")
+                std::string_view value = unquote(entry);
+                item.valueOffset = (uint32_t)(value.data() - yaml.data());
+                item.valueLength = (uint32_t)value.size();
+                push(item);
+                continue;
+            }
+            push(item);
+            // The entry's first key belongs to the item, one level deeper
+            column += (int)(entry.data() - rest.data());
+            rest = entry;
+        }
+
+        if (line.colon == line.end) continue;  // "---", "..." and the like
+        const size_t colon = line.colon - (rest.data() - yaml.data());
+        closeTo(column, false);
+
+        Node node;
+        std::string_view key = trimRight(rest.substr(0, colon));
+        std::string_view value = unquote(trimLeft(rest.substr(colon + 1)));
+        node.keyOffset = (uint32_t)(key.data() - yaml.data());
+        node.keyLength = (uint16_t)key.size();
+        node.valueOffset = (uint32_t)(value.data() - yaml.data());
+        node.valueLength = (uint32_t)value.size();
+        node.column = (int16_t)column;
+        push(node);
+    }
+    closeTo(-1, false);
+}
+
+std::string_view YAMLIndex::value(int node) const {
+    if (node < 0 || node >= (int)m_nodes.size()) return {};
+    return m_text.substr(m_nodes[node].valueOffset, m_nodes[node].valueLength);
+}
+
+std::string_view YAMLIndex::key(int node) const {
+    if (node < 0 || node >= (int)m_nodes.size()) return {};
+    return m_text.substr(m_nodes[node].keyOffset, m_nodes[node].keyLength);
+}
+
+int YAMLIndex::firstChild(int node) const {
+    if (node < 0) return m_nodes.empty() ? -1 : 0;
+    return node + 1 < (int)m_nodes[node].end ? node + 1 : -1;
+}
+
+int YAMLIndex::childCount(int node) const {
+    int count = 0;
+    int limit = node < 0 ? (int)m_nodes.size() : (int)m_nodes[node].end;
+    for (int c = firstChild(node); c >= 0 && c < limit; c = nextSibling(c)) ++count;
+    return count;
+}
+
+bool YAMLIndex::hasItems(int node) const {
+    int c = firstChild(node);
+    return c >= 0 && m_nodes[c].item;
+}
+
+int YAMLIndex::findChild(int parent, std::string_view name) const {
+    int limit = parent < 0 ? (int)m_nodes.size() : (int)m_nodes[parent].end;
+    for (int c = firstChild(parent); c >= 0 && c < limit; c = nextSibling(c)) {
+        if (!m_nodes[c].item && key(c) == name) return c;
+    }
+    return -1;
+}
+
+int YAMLIndex::find(std::string_view path) const {
+    int cur = -1;  // root
+    size_t p = 0;
+    while (p < path.size()) {
+        if (path[p] == '{') {
+            // {n}: n-th entry of the current list
+            size_t close = path.find('}', p);
+            if (close == std::string_view::npos) return -1;
+            int n = 0;
+            if (!toInt(path.substr(p + 1, close - p - 1), n) || cur < 0) return -1;
+            p = close + 1;
+            int limit = (int)m_nodes[cur].end;
+            int c = firstChild(cur);
+            for (; c >= 0 && c < limit; c = nextSibling(c)) {
+                if (m_nodes[c].item && n-- == 0) break;
+            }
+            cur = (c >= 0 && c < limit) ? c : -1;
+        } else {
+            size_t colon = path.find(':', p);
+            if (colon == std::string_view::npos) colon = path.size();
+            std::string_view name = path.substr(p, colon - p);
+            p = colon + 1;
+
+            if (p < path.size() && path[p] == '{' && cur >= 0 && hasItems(cur)) {
+                // Key:{v} on a list: the entry whose Key is v
+                size_t close = path.find('}', p);
+                if (close == std::string_view::npos) return -1;
+                std::string_view wanted = path.substr(p + 1, close - p - 1);
+                p = close + 1;
+                int limit = (int)m_nodes[cur].end;
+                int match = -1;
+                for (int c = firstChild(cur); c >= 0 && c < limit && match < 0; c = nextSibling(c)) {
+                    int field = findChild(c, name);
+                    if (field >= 0 && value(field) == wanted) match = c;
+                }
+                cur = match;
+            } else {
+                cur = findChild(cur, name);
+            }
+        }
+        if (cur < 0) return -1;
+    }
+    return cur;
+}
+
+bool YAMLIndex::get(std::string_view path, std::string_view& out) const {
+    int node = find(path);
+    if (node < 0) return false;
+    out = value(node);
+    return true;
+}
+
+bool YAMLIndex::getInt(std::string_view path, int& out) const {
+    std::string_view v;
+    return get(path, v) && toInt(v, out);
+}
+
+bool YAMLIndex::getFloat(std::string_view path, float& out) const {
+    std::string_view v;
+    return get(path, v) && toFloat(v, out);
+}
+
+int YAMLQuery::node(const YAMLIndex& index) const {
+    if (m_generation != index.generation()) {
+        m_node = index.find(m_path);
+        m_generation = index.generation();
+    }
+    return m_node;
+}
+
+std::string_view YAMLQuery::get(const YAMLIndex& index) const {
+    return index.value(node(index));
+}
+
+bool YAMLQuery::getInt(const YAMLIndex& index, int& out) const {
+    int n = node(index);
+    return n >= 0 && toInt(index.value(n), out);
+}
+
+bool YAMLQuery::getFloat(const YAMLIndex& index, float& out) const {
+    int n = node(index);
+    return n >= 0 && toFloat(index.value(n), out);
+}
+
+} // namespace utils
@@ -0,0 +1,83 @@
+#ifndef UTILS_YAML_INDEX_H
+#define UTILS_YAML_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// Structural index over a session info string: one pass records, per line,
+// the offsets of its key and value, its column and where its subtree ends.
+// Nothing is copied or converted until a path is queried, and the index
+// only holds views, so the text must outlive it.
+//
+// Paths follow the iRacing SDK query style, each key ending in ':':
+//   "WeekendInfo:TrackName:"
+//   "SessionInfo:Sessions:{2}ResultsPositions:{0}CarIdx:"   {n} = n-th list item
+//   "DriverInfo:Drivers:CarIdx:{5}UserName:"                item whose CarIdx is 5
+class YAMLIndex {
+public:
+    YAMLIndex() = default;
+    explicit YAMLIndex(std::string_view yaml) { build(yaml); }
+
+    void build(std::string_view yaml);
+
+    // Distinct for every build(), so cached query results can be checked
+    uint64_t generation() const { return m_generation; }
+    size_t nodeCount() const { return m_nodes.size(); }
+
+    // Node of the path, -1 when any step is missing
+    int find(std::string_view path) const;
+    // Scalar after the key (trimmed, quotes stripped); empty for containers
+    std::string_view value(int node) const;
+    std::string_view key(int node) const;
+    // Items of a list or keys of a map below node
+    int childCount(int node) const;
+
+    bool get(std::string_view path, std::string_view& out) const;
+    bool getInt(std::string_view path, int& out) const;
+    bool getFloat(std::string_view path, float& out) const;
+
+private:
+    struct Node {
+        uint32_t keyOffset = 0;
+        uint32_t valueOffset = 0;
+        uint32_t valueLength = 0;
+        uint32_t end = 0;        // first node after this subtree
+        uint16_t keyLength = 0;
+        int16_t column = 0;
+        bool item = false;       // "- " list entry; its first key is its child
+    };
+
+    int firstChild(int node) const;
+    int nextSibling(int node) const { return (int)m_nodes[node].end; }
+    bool hasItems(int node) const;
+    int findChild(int parent, std::string_view key) const;
+
+    std::string_view m_text;
+    std::vector<Node> m_nodes;
+    uint64_t m_generation = 0;
+};
+
+// A path whose result is cached per index generation, for queries repeated
+// every frame against a session string that only changes on updates
+class YAMLQuery {
+public:
+    explicit YAMLQuery(std::string path) : m_path(std::move(path)) {}
+
+    int node(const YAMLIndex& index) const;
+    std::string_view get(const YAMLIndex& index) const;
+    bool getInt(const YAMLIndex& index, int& out) const;
+    bool getFloat(const YAMLIndex& index, float& out) const;
+
+private:
+    std::string m_path;
+    mutable uint64_t m_generation = 0;
+    mutable int m_node = -1;
+};
+
+} // namespace utils
+
+#endif // UTILS_YAML_INDEX_H
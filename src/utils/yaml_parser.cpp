@@ -1,118 +1,281 @@
 #include "utils/yaml_parser.h"
-#include <sstream>
-#include <algorithm>
-#include <cctype>
-#include <iostream>
+#include "utils/yaml_scanner.h"
+#include <charconv>
+#include <cstring>
 
 namespace utils {
 
-std::string YAMLParser::trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\r\n");
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(" \t\r\n");
-    return str.substr(first, last - first + 1);
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool startsWith(std::string_view str, std::string_view prefix) {
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Counts leading indentation the way parse() does (tab = 2)
+int indentOf(std::string_view line) {
+    int indent = 0;
+    for (char c : line) { if (c == ' ') indent++; else if (c == '\t') indent += 2; else break; }
+    return indent;
+}
+
+// Next line starting at pos (without the '\n'); advances pos past it
+std::string_view nextLine(std::string_view text, size_t& pos) {
+    size_t eol = text.find('\n', pos);
+    if (eol == std::string_view::npos) eol = text.size();
+    std::string_view line = text.substr(pos, eol - pos);
+    pos = eol + 1;
+    return line;
+}
+
+} // namespace
+
+std::string_view YAMLParser::trim(std::string_view str) {
+    // Plain loops; find_first_not_of() searches the set once per character
+    size_t first = 0;
+    while (first < str.size() && isSpace(str[first])) ++first;
+    size_t last = str.size();
+    while (last > first && isSpace(str[last - 1])) --last;
+    return str.substr(first, last - first);
 }
 
-std::string YAMLParser::extractValue(const std::string& line) {
+std::string_view YAMLParser::extractValue(std::string_view line) {
     size_t colon = line.find(':');
-    if (colon == std::string::npos) return "";
-    std::string value = line.substr(colon + 1);
-    value = trim(value);
+    if (colon == std::string_view::npos) return {};
+    std::string_view value = trim(line.substr(colon + 1));
     if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
         value = value.substr(1, value.length() - 2);
     return value;
 }
 
-int YAMLParser::extractInt(const std::string& line) {
-    std::string v = extractValue(line);
-    try { return std::stoi(v); } catch (...) { return 0; }
+int YAMLParser::extractInt(std::string_view line) {
+    std::string_view v = extractValue(line);
+    if (!v.empty() && v.front() == '+') v.remove_prefix(1);
+    int value = 0;
+    std::from_chars(v.data(), v.data() + v.size(), value);  // leaves 0 on failure
+    return value;
 }
 
-float YAMLParser::extractFloat(const std::string& line) {
-    std::string v = extractValue(line);
-    try { return std::stof(v); } catch (...) { return 0.0f; }
+float YAMLParser::extractFloat(std::string_view line) {
+    std::string_view v = extractValue(line);
+    if (!v.empty() && v.front() == '+') v.remove_prefix(1);
+    float value = 0.0f;
+    std::from_chars(v.data(), v.data() + v.size(), value);
+    return value;
+}
+
+void YAMLParser::parseDriverField(DriverInfo& driver, std::string_view key, std::string_view line) {
+    if (key == "UserName") driver.userName = extractValue(line);
+    else if (key == "CarNumber") driver.carNumber = extractValue(line);
+    else if (key == "IRating") driver.iRating = extractInt(line);
+    else if (key == "LicLevel") driver.licenseLevel = extractInt(line);
+    else if (key == "LicSubLevel") driver.licSubLevel = extractInt(line);
+    else if (key == "LicString") driver.licString = extractValue(line);
+    else if (key == "CarPath") driver.carPath = extractValue(line);
+    else if (key == "CarClassShortName") driver.carClassShortName = extractValue(line);
+    else if (key == "CarClassID") driver.carClassId = extractInt(line);
+    else if (key == "CarIsPaceCar") driver.isPaceCar = extractInt(line) != 0;
+    else if (key == "ClubName") driver.countryCode = extractValue(line);
+    else if (key == "CarClassEstLapTime") driver.carClassEstLapTime = extractFloat(line);
+}
+
+YAMLParser::SessionInfo YAMLParser::parse(const char* yaml, size_t length) {
+    if (!yaml) return SessionInfo();
+    return parse(std::string_view(yaml, strnlen(yaml, length)));
 }
 
 YAMLParser::SessionInfo YAMLParser::parse(const char* yaml) {
-    SessionInfo info;
-    if (!yaml) return info;
+    if (!yaml) return SessionInfo();
+    return parse(std::string_view(yaml));
+}
 
-    std::istringstream stream(yaml);
-    std::string line;
-    enum Section { NONE, WEEKEND, DRIVER_INFO, SESSION_INFO };
+YAMLParser::SessionInfo YAMLParser::parse(std::string_view yaml) {
+    SessionInfo info;
+    enum Section { NONE, WEEKEND, DRIVER_INFO, SESSION_INFO, SPLIT_TIME };
     Section section = NONE;
     bool inDriversList = false;
     DriverInfo cur;
     bool building = false;
 
-    while (std::getline(stream, line)) {
-        int indent = 0;
-        for (char c : line) { if (c == ' ') indent++; else if (c == '\t') indent += 2; else break; }
-        std::string t = trim(line);
+    // Line boundaries, indentation and colons come from the scanner
+    thread_local std::vector<YAMLScanner::Line> lines;
+    YAMLScanner::scan(yaml, lines);
+
+    for (const YAMLScanner::Line& line : lines) {
+        const int indent = line.indent;
+        std::string_view t = trim(yaml.substr(line.contentBegin(), line.end - line.contentBegin()));
         if (t.empty()) continue;
+        const size_t colon = line.colon < line.end ? line.colon - (t.data() - yaml.data()) : std::string_view::npos;
 
         if (indent == 0) {
-            size_t cp = t.find(':');
-            if (cp != std::string::npos && trim(t.substr(cp + 1)).empty()) {
-                if (building && section == DRIVER_INFO) { info.drivers.push_back(cur); building = false; }
+            size_t cp = colon;
+            if (cp != std::string_view::npos && trim(t.substr(cp + 1)).empty()) {
+                if (building && section == DRIVER_INFO) { info.drivers.push_back(std::move(cur)); building = false; }
                 inDriversList = false;
-                std::string name = trim(t.substr(0, cp));
+                std::string_view name = trim(t.substr(0, cp));
                 if (name == "WeekendInfo") section = WEEKEND;
                 else if (name == "DriverInfo") section = DRIVER_INFO;
                 else if (name == "SessionInfo") section = SESSION_INFO;
+                else if (name == "SplitTimeInfo") section = SPLIT_TIME;
                 else section = NONE;
                 continue;
             }
         }
 
+        // Key up to the first colon; comparing whole keys rejects most
+        // candidates on length alone
+        std::string_view key = t.substr(0, colon);
+
         if (section == WEEKEND && indent > 0) {
-            if (t.find("TrackName:") == 0) info.trackName = extractValue(t);
-            else if (t.size() > 10 && t.substr(0, 11) == "SeriesName:") info.seriesName = extractValue(t);
+            if (key == "TrackName") info.trackName = extractValue(t);
+            else if (key == "SeriesName") info.seriesName = extractValue(t);
         }
 
         if (section == DRIVER_INFO) {
             if (t == "Drivers:") { inDriversList = true; continue; }
             if (inDriversList) {
                 if (t[0] == '-') {
-                    if (building) info.drivers.push_back(cur);
+                    if (building) info.drivers.push_back(std::move(cur));
                     cur = DriverInfo();
                     building = true;
-                    std::string ad = trim(t.substr(1));
-                    if (!ad.empty() && ad.find("CarIdx:") == 0) cur.carIdx = extractInt(ad);
+                    std::string_view ad = trim(t.substr(1));
+                    if (startsWith(ad, "CarIdx:")) cur.carIdx = extractInt(ad);
                 } else if (building && indent >= 2) {
-                    if (t.find("UserName:") == 0) cur.userName = extractValue(t);
-                    else if (t.find("CarNumber:") == 0) cur.carNumber = extractValue(t);
-                    else if (t.find("IRating:") == 0) cur.iRating = extractInt(t);
-                    else if (t.find("LicLevel:") == 0) cur.licenseLevel = extractInt(t);
-                    else if (t.find("LicSubLevel:") == 0) cur.licSubLevel = extractInt(t);
-                    else if (t.find("LicString:") == 0) cur.licString = extractValue(t);
-                    else if (t.find("CarPath:") == 0) cur.carPath = extractValue(t);
-                    else if (t.find("CarClassShortName:") == 0) cur.carClassShortName = extractValue(t);
-                    else if (t.find("ClubName:") == 0) cur.countryCode = extractValue(t);
+                    parseDriverField(cur, key, t);
                 }
             }
         }
 
         if (section == SESSION_INFO && indent > 0) {
-            if (t.find("SessionLaps:") == 0) {
-                std::string v = extractValue(t);
-                info.sessionLaps = (v == "unlimited") ? 999999 : extractInt(t);
-            } else if (t.find("SessionTime:") == 0) {
-                std::string v = extractValue(t);
-                info.sessionTime = (v == "unlimited") ? 999999.0f : extractFloat(t);
+            if (key == "SessionLaps") {
+                info.sessionLaps = (extractValue(t) == "unlimited") ? 999999 : extractInt(t);
+            } else if (key == "SessionTime") {
+                info.sessionTime = (extractValue(t) == "unlimited") ? 999999.0f : extractFloat(t);
             }
         }
+
+        if (section == SPLIT_TIME && key == "SectorStartPct") {
+            info.sectorStarts.push_back(extractFloat(t));
+        }
     }
 
-    if (building && section == DRIVER_INFO) info.drivers.push_back(cur);
+    if (building && section == DRIVER_INFO) info.drivers.push_back(std::move(cur));
+    return info;
+}
 
-    std::cout << "[YAML] series=\"" << info.seriesName << "\" drivers=" << info.drivers.size() << "\n";
-    for (size_t i = 0; i < std::min(info.drivers.size(), (size_t)3); ++i) {
-        auto& d = info.drivers[i];
-        std::cout << "[YAML]   [" << d.carIdx << "] \"" << d.userName << "\" iR=" << d.iRating
-                  << " licSub=" << d.licSubLevel << " club=\"" << d.countryCode << "\"\n";
+uint64_t YAMLParser::hash(std::string_view text) {
+    // Four independent lanes of eight bytes so the multiplies overlap; it
+    // only has to tell revisions of one block apart
+    const uint64_t kMul = 0xFF51AFD7ED558CCDull;
+    uint64_t lane[4] = { 0x9E3779B97F4A7C15ull ^ text.size(), 0xC2B2AE3D27D4EB4Full,
+                         0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull };
+    const char* p = text.data();
+    size_t n = text.size();
+    for (; n >= 32; p += 32, n -= 32) {
+        for (int i = 0; i < 4; ++i) {
+            uint64_t word;
+            memcpy(&word, p + i * 8, 8);
+            lane[i] = (lane[i] ^ word) * kMul;
+            lane[i] ^= lane[i] >> 32;
+        }
     }
-    return info;
+    uint64_t h = lane[0] ^ (lane[1] * 3) ^ (lane[2] * 5) ^ (lane[3] * 7);
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        h = (h ^ word) * kMul;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, p, n);
+    h = (h ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 29);
+}
+
+void YAMLParser::splitSections(std::string_view yaml, std::vector<Block>& out) {
+    out.clear();
+    thread_local std::vector<YAMLScanner::Line> lines;
+    YAMLScanner::scan(yaml, lines);
+
+    for (const YAMLScanner::Line& line : lines) {
+        if (line.lead != 0 || line.end == line.begin || isSpace(yaml[line.begin])) continue;
+        // An unindented line closes the previous section and opens the next
+        if (!out.empty()) {
+            size_t prev = out.back().text.data() - yaml.data();
+            out.back().text = yaml.substr(prev, line.begin - prev);
+        }
+        Block block;
+        block.name = trim(yaml.substr(line.begin, line.colon - line.begin));
+        block.text = yaml.substr(line.begin);
+        out.push_back(block);
+    }
+}
+
+void YAMLParser::splitDrivers(std::string_view section, std::vector<Block>& out) {
+    out.clear();
+    size_t entryStart = std::string_view::npos;
+    auto close = [&](size_t end) {
+        if (entryStart == std::string_view::npos) return;
+        Block block;
+        block.text = section.substr(entryStart, end - entryStart);
+        block.hash = hash(block.text);
+        std::string_view first = trim(block.text.substr(0, block.text.find('\n')));
+        std::string_view ad = trim(first.substr(1));
+        if (startsWith(ad, "CarIdx:")) block.carIdx = extractInt(ad);
+        out.push_back(block);
+    };
+
+    // Same entry rules as parse(): after a "Drivers:" line, every line
+    // whose first non-blank is '-' opens an entry that runs up to the next.
+    // '-' is rare in the values, so jumping between dashes beats walking lines.
+    auto lineStart = [&](size_t at) {
+        size_t nl = section.rfind('\n', at);
+        return nl == std::string_view::npos ? 0 : nl + 1;
+    };
+    auto onlyBlanksBefore = [&](size_t at, size_t start) {
+        for (size_t i = start; i < at; ++i) if (!isSpace(section[i])) return false;
+        return true;
+    };
+
+    size_t pos = section.find("Drivers:");
+    while (pos != std::string_view::npos) {
+        size_t start = lineStart(pos);
+        size_t eol = section.find('\n', pos);
+        std::string_view line = section.substr(start, (eol == std::string_view::npos ? section.size() : eol) - start);
+        if (trim(line) == "Drivers:") break;
+        pos = section.find("Drivers:", pos + 1);
+    }
+    if (pos == std::string_view::npos) return;
+
+    for (pos = section.find('-', pos); pos != std::string_view::npos; pos = section.find('-', pos + 1)) {
+        size_t start = lineStart(pos);
+        if (!onlyBlanksBefore(pos, start)) continue;
+        close(start);
+        entryStart = start;
+    }
+    close(section.size());
+}
+
+YAMLParser::DriverInfo YAMLParser::parseDriver(std::string_view entry) {
+    DriverInfo driver;
+    size_t pos = 0;
+    bool first = true;
+    while (pos < entry.size()) {
+        std::string_view line = nextLine(entry, pos);
+        std::string_view t = trim(line);
+        if (t.empty()) continue;
+        if (first) {
+            std::string_view ad = trim(t.substr(1));
+            if (startsWith(ad, "CarIdx:")) driver.carIdx = extractInt(ad);
+            first = false;
+        } else if (indentOf(line) >= 2) {
+            parseDriverField(driver, t.substr(0, t.find(':')), t);
+        }
+    }
+    return driver;
 }
 
 } // namespace utils
@@ -1,7 +1,9 @@
 #ifndef UTILS_YAML_PARSER_H
 #define UTILS_YAML_PARSER_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 
@@ -19,7 +21,10 @@ public:
         std::string licString;
         std::string carPath;
         std::string carClassShortName;
+        int carClassId = 0;
+        bool isPaceCar = false;
         std::string countryCode;   // e.g. "ES", "NL", "US"
+        float carClassEstLapTime = 0.0f;  // seconds, 0 when absent
     };
 
     struct SessionInfo {
@@ -27,16 +32,39 @@ public:
         std::string trackName;
         int sessionLaps = 0;
         float sessionTime = 0.0f;
+        std::vector<float> sectorStarts;  // SplitTimeInfo, lap fractions in file order
         std::vector<DriverInfo> drivers;
     };
 
+    // Single pass over the buffer in place: lines and values are views
+    // into it, numbers go through from_chars. Only the returned strings
+    // allocate.
+    static SessionInfo parse(std::string_view yaml);
     static SessionInfo parse(const char* yaml);
+    // Bounded variant for session strings that are not NUL-terminated
+    static SessionInfo parse(const char* yaml, size_t length);
+
+    // Incremental updates: a session string split into top-level sections
+    // ("WeekendInfo:" up to the next unindented line) and DriverInfo into
+    // one block per "- CarIdx:" entry, so callers can hash the blocks and
+    // reparse only those whose hash changed. Views into the input.
+    struct Block {
+        std::string_view name;   // section key; empty for driver entries
+        std::string_view text;
+        uint64_t hash = 0;       // driver entries only; hash(text) for sections
+        int carIdx = -1;         // driver entries only
+    };
+    static void splitSections(std::string_view yaml, std::vector<Block>& out);
+    static void splitDrivers(std::string_view driverInfoSection, std::vector<Block>& out);
+    static DriverInfo parseDriver(std::string_view entry);
+    static uint64_t hash(std::string_view text);
 
 private:
-    static std::string trim(const std::string& str);
-    static std::string extractValue(const std::string& line);
-    static int extractInt(const std::string& line);
-    static float extractFloat(const std::string& line);
+    static std::string_view trim(std::string_view str);
+    static std::string_view extractValue(std::string_view line);
+    static int extractInt(std::string_view line);
+    static float extractFloat(std::string_view line);
+    static void parseDriverField(DriverInfo& driver, std::string_view key, std::string_view line);
 };
 
 } // namespace utils
@@ -0,0 +1,270 @@
+#include "utils/yaml_scanner.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YAML_SCANNER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(YAML_SCANNER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define YAML_TARGET(isa) __attribute__((target(isa)))
+#else
+#define YAML_TARGET(isa)
+#endif
+
+namespace utils {
+
+namespace {
+
+// Without vector units, classifying every byte into masks loses to
+// memchr() per line, so the fallback walks lines directly
+void scanScalar(std::string_view text, std::vector<YAMLScanner::Line>& out) {
+    out.clear();
+    const char* data = text.data();
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const char* nl = static_cast<const char*>(memchr(data + pos, '\n', text.size() - pos));
+        const size_t end = nl ? (size_t)(nl - data) : text.size();
+
+        YAMLScanner::Line line;
+        line.begin = (uint32_t)pos;
+        line.end = (uint32_t)end;
+        size_t at = pos;
+        int tabs = 0;
+        for (; at < end && (data[at] == ' ' || data[at] == '\t'); ++at) tabs += data[at] == '\t';
+        line.lead = (uint16_t)(at - pos);
+        line.indent = (uint16_t)(line.lead + tabs);
+        const char* colon = static_cast<const char*>(memchr(data + at, ':', end - at));
+        line.colon = colon ? (uint32_t)(colon - data) : (uint32_t)end;
+        out.push_back(line);
+        pos = end + 1;
+    }
+}
+
+#ifdef YAML_SCANNER_X86
+
+constexpr uint32_t kNone = UINT32_MAX;
+constexpr size_t kBlock = 64;
+
+// Byte classes of one 64-byte block, bit i = byte i
+struct BlockMasks {
+    uint64_t newline;
+    uint64_t colon;
+    uint64_t blank;  // ' ' or '\t'
+    uint64_t tab;
+};
+
+int lowestBit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+int bitCount(uint64_t mask) {
+    return (int)std::bitset<64>(mask).count();
+}
+
+// Turns block masks into lines. Shared by every implementation; only the
+// mask computation differs. The state of the line in progress is copied
+// to locals per block so stores into the output cannot force reloads.
+class LineBuilder {
+public:
+    explicit LineBuilder(std::vector<YAMLScanner::Line>& out) : m_out(out) {}
+
+    void consume(const BlockMasks& m, uint32_t base) {
+        uint32_t begin = m_begin, colon = m_colon, leadEnd = m_leadEnd;
+        int tabs = m_tabs;
+        uint64_t live = ~0ull;
+        for (;;) {
+            const uint64_t newlines = m.newline & live;
+            // Bits of this line within the block, the newline included
+            const uint64_t line = newlines ? (live & (newlines ^ (newlines - 1))) : live;
+
+            if (leadEnd == kNone) {
+                uint64_t content = ~m.blank & line;
+                if (m.tab) {
+                    uint64_t leading = content ? line & ((content & (0 - content)) - 1) : line;
+                    tabs += bitCount(m.tab & leading);
+                }
+                if (content) leadEnd = base + lowestBit(content);
+            }
+            if (colon == kNone && (m.colon & line)) colon = base + lowestBit(m.colon & line);
+
+            if (!newlines) break;
+            const uint32_t end = base + (uint32_t)lowestBit(newlines);
+            YAMLScanner::Line out;
+            out.begin = begin;
+            out.end = end;
+            out.colon = std::min(colon, end);
+            out.lead = (uint16_t)(std::min(leadEnd, end) - begin);
+            out.indent = (uint16_t)(out.lead + tabs);
+            if (m_count == m_out.size()) m_out.resize(m_out.size() * 2 + 64);
+            m_out[m_count++] = out;
+
+            begin = end + 1;
+            colon = kNone;
+            leadEnd = kNone;
+            tabs = 0;
+            const uint32_t next = end - base + 1;
+            if (next == kBlock) break;
+            live = ~0ull << next;
+        }
+        m_begin = begin;
+        m_colon = colon;
+        m_leadEnd = leadEnd;
+        m_tabs = tabs;
+    }
+
+    void finish(uint32_t size) {
+        m_out.resize(m_count);
+        if (m_begin >= size) return;
+        YAMLScanner::Line out;
+        out.begin = m_begin;
+        out.end = size;
+        out.colon = std::min(m_colon, size);
+        out.lead = (uint16_t)(std::min(m_leadEnd, size) - m_begin);
+        out.indent = (uint16_t)(out.lead + m_tabs);
+        m_out.push_back(out);
+    }
+
+private:
+    std::vector<YAMLScanner::Line>& m_out;
+    size_t m_count = 0;  // lines written; m_out is sized ahead and trimmed in finish()
+    uint32_t m_begin = 0;
+    uint32_t m_colon = kNone;
+    uint32_t m_leadEnd = kNone;
+    int m_tabs = 0;
+};
+
+YAML_TARGET("sse2")
+void masksSSE2(const char* p, BlockMasks& m) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    m = BlockMasks{};
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        __m128i t = _mm_cmpeq_epi8(v, tab);
+        const int shift = i * 16;
+        m.newline |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)) << shift;
+        m.colon |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, colon)) << shift;
+        m.blank |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, space), t)) << shift;
+        m.tab |= (uint64_t)(uint16_t)_mm_movemask_epi8(t) << shift;
+    }
+}
+
+YAML_TARGET("avx2")
+void masksAVX2(const char* p, BlockMasks& m) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    m = BlockMasks{};
+    for (int i = 0; i < 2; ++i) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 32));
+        __m256i t = _mm256_cmpeq_epi8(v, tab);
+        const int shift = i * 32;
+        m.newline |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)) << shift;
+        m.colon |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, colon)) << shift;
+        m.blank |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), t)) << shift;
+        m.tab |= (uint64_t)(uint32_t)_mm256_movemask_epi8(t) << shift;
+    }
+}
+
+// One loop per implementation, so each mask function inlines into a loop
+// compiled for its own instruction set
+#define YAML_SCAN_LOOP(masks)                                           \
+    out.resize(text.size() / 16); /* lines run 20-30 bytes */           \
+    LineBuilder builder(out);                                           \
+    BlockMasks m;                                                       \
+    size_t pos = 0;                                                     \
+    for (; pos + kBlock <= text.size(); pos += kBlock) {                \
+        masks(text.data() + pos, m);                                    \
+        builder.consume(m, (uint32_t)pos);                              \
+    }                                                                   \
+    if (pos < text.size()) {                                            \
+        /* Tail padded with a byte of no class of interest */           \
+        char tail[kBlock];                                              \
+        memset(tail, 'x', sizeof(tail));                                \
+        memcpy(tail, text.data() + pos, text.size() - pos);             \
+        masks(tail, m);                                                 \
+        builder.consume(m, (uint32_t)pos);                              \
+    }                                                                   \
+    builder.finish((uint32_t)text.size());
+
+YAML_TARGET("sse2")
+void scanSSE2(std::string_view text, std::vector<YAMLScanner::Line>& out) {
+    YAML_SCAN_LOOP(masksSSE2)
+}
+
+YAML_TARGET("avx2")
+void scanAVX2(std::string_view text, std::vector<YAMLScanner::Line>& out) {
+    YAML_SCAN_LOOP(masksAVX2)
+}
+
+#undef YAML_SCAN_LOOP
+
+#endif // YAML_SCANNER_X86
+
+YAMLScanner::Isa detect() {
+#ifdef YAML_SCANNER_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuidex(info, 7, 0);
+        bool avx2 = (info[1] & (1 << 5)) != 0;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (avx2 && osxsave && (_xgetbv(0) & 6) == 6) return YAMLScanner::Isa::AVX2;
+    }
+    return YAMLScanner::Isa::SSE2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return YAMLScanner::Isa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return YAMLScanner::Isa::SSE2;
+#endif
+#endif
+    return YAMLScanner::Isa::Scalar;
+}
+
+} // namespace
+
+YAMLScanner::Isa YAMLScanner::detectedIsa() {
+    static const Isa isa = detect();
+    return isa;
+}
+
+const char* YAMLScanner::isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2: return "avx2";
+        case Isa::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void YAMLScanner::scan(std::string_view text, std::vector<Line>& out) {
+    scan(text, out, detectedIsa());
+}
+
+void YAMLScanner::scan(std::string_view text, std::vector<Line>& out, Isa isa) {
+    out.clear();
+    isa = std::min(isa, detectedIsa());
+#ifdef YAML_SCANNER_X86
+    if (isa == Isa::AVX2) { scanAVX2(text, out); return; }
+    if (isa == Isa::SSE2) { scanSSE2(text, out); return; }
+#endif
+    scanScalar(text, out);
+}
+
+} // namespace utils
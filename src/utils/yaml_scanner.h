@@ -0,0 +1,41 @@
+#ifndef UTILS_YAML_SCANNER_H
+#define UTILS_YAML_SCANNER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// Structural pre-pass over a session string: one vectorised sweep finds
+// every newline, the first colon of each line and the end of its leading
+// indentation, so the parsers above work line by line without searching
+// byte by byte again. 64-byte blocks are classified into bitmasks with
+// AVX2 or SSE2 (picked at runtime); without either, a memchr() line walk.
+class YAMLScanner {
+public:
+    struct Line {
+        uint32_t begin = 0;    // first byte of the line
+        uint32_t end = 0;      // the '\n' (or the end of the text)
+        uint32_t colon = 0;    // first ':' in the line, == end when none
+        uint16_t lead = 0;     // leading blanks in bytes
+        uint16_t indent = 0;   // same with a tab counting 2, as the parsers do
+
+        uint32_t contentBegin() const { return begin + lead; }
+    };
+
+    enum class Isa { Scalar, SSE2, AVX2 };
+
+    // Best implementation this CPU supports
+    static Isa detectedIsa();
+    static const char* isaName(Isa isa);
+
+    static void scan(std::string_view text, std::vector<Line>& out);
+    // Forced implementation (benchmarks, cross-checks); clamped to what
+    // the CPU supports
+    static void scan(std::string_view text, std::vector<Line>& out, Isa isa);
+};
+
+} // namespace utils
+
+#endif // UTILS_YAML_SCANNER_H